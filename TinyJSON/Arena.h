@@ -0,0 +1,95 @@
+#ifndef TINY_JSON_ARENA_H
+#define TINY_JSON_ARENA_H
+
+#include "noncopyable.h"
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+
+namespace json
+{
+
+// A monotonic arena which keeps its memory when it is released. The blocks it had to take from upstream
+// are merged into one initial buffer, so the same allocations after release() don't go upstream at all.
+class Arena : public std::pmr::memory_resource, noncopyable
+{
+public:
+    explicit Arena(std::pmr::memory_resource* _upstream = std::pmr::get_default_resource()) : upstream(_upstream) {
+        monotonic.emplace(&upstream);
+    }
+
+    ~Arena() override {
+        monotonic.reset();
+        freeBuffer();
+    }
+
+    // Free everything at once. With keepMemory the arena keeps enough memory for as much again,
+    // otherwise all of it goes back upstream.
+    void release(bool keepMemory = true) {
+        monotonic.reset();
+        if (!keepMemory) {
+            freeBuffer();
+        } else if (upstream.allocated > 0) {
+            size_t size = bufferSize + upstream.allocated;
+            freeBuffer();
+            buffer = upstream.resource->allocate(size, alignof(std::max_align_t));
+            bufferSize = size;
+        }
+        upstream.allocated = 0;
+        if (buffer) {
+            monotonic.emplace(buffer, bufferSize, &upstream);
+        } else {
+            monotonic.emplace(&upstream);
+        }
+    }
+
+    // The memory kept for reuse
+    [[nodiscard]] size_t capacity() const { return bufferSize; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override { return monotonic->allocate(bytes, alignment); }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    [[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+
+    void freeBuffer() {
+        if (buffer) upstream.resource->deallocate(buffer, bufferSize, alignof(std::max_align_t));
+        buffer = nullptr;
+        bufferSize = 0;
+    }
+
+    // Counts what the arena takes beyond its buffer
+    class Upstream : public std::pmr::memory_resource
+    {
+    public:
+        explicit Upstream(std::pmr::memory_resource* _resource) : resource(_resource) {}
+
+        size_t allocated = 0;
+        std::pmr::memory_resource* resource;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            allocated += bytes;
+            return resource->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            resource->deallocate(p, bytes, alignment);
+        }
+
+        [[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    Upstream upstream;
+    void* buffer = nullptr;  // from upstream, like the blocks it replaces
+    size_t bufferSize = 0;
+    std::optional<std::pmr::monotonic_buffer_resource> monotonic;  // replaced to start from a new buffer
+};
+
+}  // namespace json
+
+#endif  // TINY_JSON_ARENA_H
@@ -1,29 +1,134 @@
 #ifndef TINY_JSON_DOCUMENT_H
 #define TINY_JSON_DOCUMENT_H
 
+#include "Arena.h"
 #include "Reader.h"
 #include "ReadStream.h"
+#include "StringPool.h"
 #include "Value.h"
 
+#include <memory>
+#include <memory_resource>
 #include <string>
-#include <stack>
+#include <vector>
 
 namespace json
 {
 
 class Document : public Value
 {
+    // builds one array from the documents parsed by its workers
+    friend class ParallelReader;
+
 public:
-    ParseError parse(const char* json, size_t len) { return parse(std::string_view(json, len)); }
+    // Where the strings, arrays and objects of the document are allocated
+    enum Allocation
+    {
+        ALLOC_HEAP,      // one heap allocation per node, nodes may outlive the document
+        ALLOC_ARENA,     // a per-document arena released at once, nodes must not outlive the document
+        ALLOC_RESOURCE,  // the memory resource given to the document, which must outlive the nodes
+    };
+
+    // Which strings are taken from a StringPool, so that equal ones are stored once
+    enum Interning
+    {
+        INTERN_NONE,
+        INTERN_KEYS,     // object keys
+        INTERN_STRINGS,  // object keys and string values up to StringPool::MAX_VALUE_LENGTH bytes
+    };
+
+    Document() = default;
+
+    // Strings are looked up in "shared" first, then in a pool of the document
+    explicit Document(Allocation mode, Interning _interning = INTERN_NONE,
+                      std::shared_ptr<const StringPool> shared = nullptr)
+            : Document(mode, OWN_SHARED, _interning, std::move(shared)) {}
+
+    // How the parsed strings, arrays and objects are held, pooled strings are always shared.
+    // OWN_BORROWED needs ALLOC_ARENA: no node is counted or destroyed, the arena is released at once,
+    // so a string, array or object added to the document later must not own memory outside the arena.
+    Document(Allocation mode, Ownership _ownership, Interning _interning = INTERN_NONE,
+             std::shared_ptr<const StringPool> shared = nullptr)
+            : interning(_interning), ownership(_ownership), sharedPool(std::move(shared)) {
+        assert(mode != ALLOC_RESOURCE && "pass the memory resource instead");
+        assert((ownership != OWN_BORROWED || mode == ALLOC_ARENA) && "borrowed nodes must live in an arena");
+        if (mode == ALLOC_ARENA) arena = std::make_unique<Arena>();
+        if (interning != INTERN_NONE) pool = std::make_unique<StringPool>(resource());
+    }
+
+    // Allocate the nodes, and the pool, from "resource": a monotonic buffer on the stack, a per-thread pool...
+    // With OWN_BORROWED nothing is ever returned to it, it must outlive the document and be released by its owner.
+    explicit Document(std::pmr::memory_resource* _resource, Ownership _ownership = OWN_SHARED,
+                      Interning _interning = INTERN_NONE, std::shared_ptr<const StringPool> shared = nullptr)
+            : userResource(_resource), interning(_interning), ownership(_ownership), sharedPool(std::move(shared)) {
+        assert(userResource != nullptr);
+        if (interning != INTERN_NONE) pool = std::make_unique<StringPool>(resource());
+    }
+
+    Document(Document&& rhs) noexcept = default;
+
+    Document& operator=(Document&& rhs) noexcept {
+        if (this == &rhs) return *this;
+        // release the nodes before the arena they may live in, the pool may live in the arena too
+        release();
+        key = Value();
+        pool = std::move(rhs.pool);
+        sharedPool = std::move(rhs.sharedPool);
+        interning = rhs.interning;
+        ownership = rhs.ownership;
+        userResource = rhs.userResource;
+        arena = std::move(rhs.arena);
+        adopted = std::move(rhs.adopted);
+        Value::operator=(std::move(rhs));
+        st = std::move(rhs.st);
+        context = std::move(rhs.context);
+        key = std::move(rhs.key);
+        isFirstValue = rhs.isFirstValue;
+        return *this;
+    }
+
+    ~Document() {
+        // the base class is destroyed after the arena, release the nodes first
+        release();
+    }
+
+    // Drop the parsed value so that the document can parse again, which parse() also does.
+    // The buffers of the parser are kept, in arena mode all the nodes are released in one step
+    // and with keepMemory the arena keeps enough memory to parse as much again without allocating.
+    // The pool of a heap document keeps its strings, which are likely to repeat in the next one.
+    void reset(bool keepMemory = true) {
+        release();
+        key = Value();
+        st.clear();
+        isFirstValue = true;
+        if (pool && getAllocation() != ALLOC_HEAP) pool->clear();
+        adopted.clear();
+        if (arena) arena->release(keepMemory);
+        if (!keepMemory) {
+            st.shrink_to_fit();
+            context = Reader::Context();
+        }
+    }
+
+    [[nodiscard]] Allocation getAllocation() const {
+        return arena ? ALLOC_ARENA : userResource ? ALLOC_RESOURCE : ALLOC_HEAP;
+    }
+
+    [[nodiscard]] Interning getInterning() const { return interning; }
 
-    ParseError parse(std::string_view json) {
+    [[nodiscard]] Ownership getOwnership() const { return ownership; }
+
+    ParseResult parse(const char* json, size_t len) { return parse(std::string_view(json, len)); }
+
+    ParseResult parse(std::string_view json) {
         StringReadStream is(json);
         return parseStream(is);
     }
 
     template<typename ReadStream>
-    ParseError parseStream(ReadStream& is) {
-        return Reader::parse(is, *this);
+    ParseResult parseStream(ReadStream& is, size_t maxDepth = Reader::DEFAULT_MAX_DEPTH) {
+        if (!isFirstValue) reset();
+        return Reader::parse(is, *this, context, maxDepth);
     }
 
 public:
@@ -53,50 +158,90 @@ public:
     }
 
     bool String(std::string_view s) {
-        add(Value(s));
+        add(makeString(s, false));
         return true;
     }
 
     bool StartObject() {
-        st.emplace(add(Value::emptyObject()));
+        st.emplace_back(add(Value(make<Object>(), ownership)));
         return true;
     }
 
     bool Key(std::string_view s) {
-        add(Value(s));
+        add(makeString(s, true));
         return true;
     }
 
     bool EndObject() {
         assert(!st.empty());
-        assert(st.top().type() == TYPE_OBJECT_PTR);
-        st.pop();
+        assert(st.back().type() == TYPE_OBJECT_PTR);
+        Object& members = st.back().value->object();
+        if (members.size() >= Object::INDEX_THRESHOLD) members.reindex();
+        st.pop_back();
         return true;
     }
 
     bool StartArray() {
-        st.emplace(add(Value::emptyArray()));
+        st.emplace_back(add(Value(make<Array>(), ownership)));
         return true;
     }
 
     bool EndArray() {
         assert(!st.empty());
-        assert(st.top().type() == TYPE_ARRAY_PTR);
-        st.pop();
+        assert(st.back().type() == TYPE_ARRAY_PTR);
+        st.pop_back();
         return true;
     }
 
 private:
+    // In arena mode the node, the container and its elements all come from the arena
+    template<typename T, typename... Args>
+    NodePtr<T> make(Args&& ... args) {
+        return NodePtr<T>::make(resource(), std::forward<Args>(args)...);
+    }
+
+    std::pmr::memory_resource* resource() const {
+        if (userResource) return userResource;
+        return arena ? arena.get() : std::pmr::get_default_resource();
+    }
+
+    Value makeString(std::string_view s, bool isKey) {
+        // short strings are stored inline, which beats sharing them
+        if (s.size() <= Value::SHORT_STRING_LENGTH) return Value(s);
+        if (interning == INTERN_STRINGS ? isKey || s.size() <= StringPool::MAX_VALUE_LENGTH
+                                        : interning == INTERN_KEYS && isKey) {
+            if (sharedPool) {
+                // the document holds on to the shared pool
+                if (const StringPtr* found = sharedPool->find(s)) {
+                    return ownership == OWN_BORROWED ? Value::borrow(*found) : Value(*found);
+                }
+            }
+            if (pool) {
+                if (StringPtr str = pool->intern(s)) return Value(std::move(str));
+            }
+        }
+        return Value(make<json::String>(s), ownership);
+    }
+
+    // Keep the arena of "part" alive as long as this document, for the nodes which were moved here from it
+    void adopt(Document&& part) {
+        part.release();
+        part.key = Value();
+        if (part.arena) adopted.push_back(std::move(part.arena));
+        for (auto& a: part.adopted) adopted.push_back(std::move(a));
+        part.adopted.clear();
+    }
+
     Value* add(Value&& value) {
         if (isFirstValue) {
             isFirstValue = false;
-            data = value.data;
+            Value::operator=(std::move(value));
             return this;
         } else {
             assert(!st.empty() && "root not singular");
         }
 
-        Level& top = st.top();
+        Level& top = st.back();
         if (top.type() == TYPE_ARRAY_PTR) {
             top.value->addToArray(std::move(value));
             top.valueCount++;
@@ -109,7 +254,7 @@ private:
                 top.valueCount++;
                 return &key;
             } else {
-                top.value->addPair(std::move(key), std::move(value));
+                top.value->object().emplace_back(std::move(key), std::move(value));
                 top.valueCount++;
                 return top.lastValue();
             }
@@ -125,10 +270,10 @@ private:
 
         [[nodiscard]] Value* lastValue() const {
             if (type() == TYPE_ARRAY_PTR) {
-                return &std::get<ArrayPtr>(value->data)->back();
+                return &value->array().back();
             } else {
                 assert(type() == TYPE_OBJECT_PTR);
-                return &std::get<ObjectPtr>(value->data)->back().second;
+                return &value->object().back().second;
             }
         }
 
@@ -137,7 +282,16 @@ private:
     };
 
 private:
-    std::stack<Level> st;
+    std::pmr::memory_resource* userResource = nullptr;
+    // declared first so that it outlives every node allocated from it
+    std::unique_ptr<Arena> arena;
+    std::vector<std::unique_ptr<Arena>> adopted;  // arenas of adopted documents
+    Interning interning = INTERN_NONE;
+    Ownership ownership = OWN_SHARED;
+    std::unique_ptr<StringPool> pool;  // its strings and table come from the arena, if there is one
+    std::shared_ptr<const StringPool> sharedPool;
+    std::vector<Level> st;  // the open arrays and objects, kept with the context for the next parse
+    Reader::Context context;
     Value key;
     bool isFirstValue = true;
 };
@@ -3,6 +3,8 @@
 
 #include <exception>
 #include <cassert>
+#include <cstddef>
+#include <string_view>
 
 namespace json
 {
@@ -22,7 +24,9 @@ namespace json
   XX(MISS_KEY, "miss key") \
   XX(MISS_COLON, "miss colon") \
   XX(MISS_COMMA_OR_CURLY_BRACKET, "miss comma or curly bracket") \
-  XX(USER_STOPPED, "user stopped parse")
+  XX(USER_STOPPED, "user stopped parse") \
+  XX(DEPTH_EXCEEDED, "nesting too deep") \
+  XX(DOCUMENT_TOO_LARGE, "document too large")
 
 enum ParseError
 {
@@ -41,6 +45,42 @@ inline const char* parseErrorStr(ParseError err) {
     return tab[err];
 }
 
+// The outcome of a parse: the error code and, on failure, the byte offset where it was detected.
+// It converts to ParseError, so it can be used wherever a ParseError is expected.
+class ParseResult
+{
+public:
+    ParseResult() = default;
+
+    ParseResult(ParseError err, size_t off) : error(err), offset(off) {}
+
+    operator ParseError() const { return error; }
+
+    [[nodiscard]] ParseError err() const { return error; }
+
+    // Byte offset into the parsed input, 0 on success
+    [[nodiscard]] size_t getOffset() const { return offset; }
+
+    // 1-based line of the error, counted over the parsed input only when asked for
+    [[nodiscard]] size_t line(std::string_view input) const {
+        size_t n = 1;
+        for (char ch: input.substr(0, offset)) {
+            if (ch == '\n') n++;
+        }
+        return n;
+    }
+
+    // 1-based column of the error in bytes, counted over the parsed input only when asked for
+    [[nodiscard]] size_t column(std::string_view input) const {
+        size_t lineStart = input.substr(0, offset).rfind('\n');
+        return lineStart == std::string_view::npos ? offset + 1 : offset - lineStart;
+    }
+
+private:
+    ParseError error = PARSE_OK;
+    size_t offset = 0;
+};
+
 class Exception : public std::exception
 {
 public:
@@ -0,0 +1,168 @@
+#ifndef TINY_JSON_NUMBER_H
+#define TINY_JSON_NUMBER_H
+
+#include "PowersOfFive.h"
+
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+
+namespace json::number
+{
+
+// Number conversions of Reader and Writer.
+//
+// Conversion of a decimal significand and exponent, as accumulated by Reader, to the nearest double.
+// The exact cases are tried first (Clinger), then the Eisel-Lemire algorithm, which decides
+// the rounding of all but a tiny fraction of inputs from a 128-bit product.
+
+inline constexpr double EXACT_POWERS_OF_TEN[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// Bits of a double
+constexpr int MANTISSA_BITS = 52;
+constexpr int MINIMUM_EXPONENT = -1023;
+constexpr int INFINITE_POWER = 0x7FF;
+
+inline double makeDouble(uint64_t mantissa, int power2, bool negative) {
+    return std::bit_cast<double>(mantissa | static_cast<uint64_t>(power2) << MANTISSA_BITS |
+                                 static_cast<uint64_t>(negative) << 63);
+}
+
+// floor(log2(10^q)) + 63
+inline int power(int q) { return ((152170 + 65536) * q >> 16) + 63; }
+
+// Set d to (negative ? -1 : 1) * w * 10^q, which is infinite if it overflows.
+// Returns false in the rare case that 128 bits are not enough to round correctly,
+// the caller has to fall back to a slower conversion then.
+inline bool toDouble(uint64_t w, int64_t q, bool negative, double& d) {
+    // both w and 10^|q| are exact doubles, one rounding in the multiplication or division
+    if (q >= -22 && q <= 22 && w <= uint64_t{1} << 53) {
+        d = static_cast<double>(w);
+        d = q < 0 ? d / EXACT_POWERS_OF_TEN[-q] : d * EXACT_POWERS_OF_TEN[q];
+        if (negative) d = -d;
+        return true;
+    }
+    if (w == 0 || q < SMALLEST_POWER_OF_FIVE) {
+        d = makeDouble(0, 0, negative);
+        return true;
+    }
+    if (q > LARGEST_POWER_OF_FIVE) {
+        d = makeDouble(0, INFINITE_POWER, negative);
+        return true;
+    }
+
+    int lz = std::countl_zero(w);
+    w <<= lz;
+
+    // the product of w and 5^q, only the top MANTISSA_BITS + 3 bits matter
+    const uint64_t* pow5 = POWERS_OF_FIVE[q - SMALLEST_POWER_OF_FIVE];
+    unsigned __int128 product = static_cast<unsigned __int128>(w) * pow5[0];
+    auto high = static_cast<uint64_t>(product >> 64);
+    auto low = static_cast<uint64_t>(product);
+    const uint64_t precisionMask = ~uint64_t{0} >> (MANTISSA_BITS + 3);
+    if ((high & precisionMask) == precisionMask) {
+        // the truncated bits may carry into the top ones, add the second word of 5^q
+        auto second = static_cast<uint64_t>(static_cast<unsigned __int128>(w) * pow5[1] >> 64);
+        low += second;
+        if (second > low) high++;
+        // still ambiguous, outside the range where this is proven not to matter
+        if (low == ~uint64_t{0} && (q < -27 || q > 55)) return false;
+    }
+
+    auto upperBit = static_cast<int>(high >> 63);
+    int shift = upperBit + 64 - MANTISSA_BITS - 3;
+    uint64_t mantissa = high >> shift;
+    int power2 = power(static_cast<int>(q)) + upperBit - lz - MINIMUM_EXPONENT;
+
+    if (power2 <= 0) {
+        // subnormal
+        if (-power2 + 1 >= 64) {
+            d = makeDouble(0, 0, negative);
+            return true;
+        }
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        power2 = mantissa < uint64_t{1} << MANTISSA_BITS ? 0 : 1;
+        d = makeDouble(mantissa & ~(uint64_t{1} << MANTISSA_BITS), power2, negative);
+        return true;
+    }
+
+    // exactly halfway between two doubles, which only happens for small q: round to even
+    if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && mantissa << shift == high) {
+        mantissa &= ~uint64_t{1};
+    }
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= uint64_t{2} << MANTISSA_BITS) {
+        mantissa = uint64_t{1} << MANTISSA_BITS;
+        power2++;
+    }
+    mantissa &= ~(uint64_t{1} << MANTISSA_BITS);
+    if (power2 >= INFINITE_POWER) {
+        power2 = INFINITE_POWER;
+        mantissa = 0;
+    }
+    d = makeDouble(mantissa, power2, negative);
+    return true;
+}
+
+// Formatting for Writer. Each function writes at most MAX_NUMBER_LENGTH bytes to buf,
+// without a terminating NUL, and returns the end of what it wrote.
+
+constexpr size_t MAX_NUMBER_LENGTH = 32;
+
+// "00", "01", ..., "99"
+inline constexpr char TWO_DIGITS[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+// Two digits per division, from the least significant end
+inline char* writeUint64(uint64_t u, char* buf) {
+    char digits[20];
+    char* p = digits + sizeof(digits);
+    while (u >= 100) {
+        p -= 2;
+        memcpy(p, TWO_DIGITS + u % 100 * 2, 2);
+        u /= 100;
+    }
+    if (u >= 10) {
+        p -= 2;
+        memcpy(p, TWO_DIGITS + u * 2, 2);
+    } else {
+        *--p = static_cast<char>('0' + u);
+    }
+    auto len = static_cast<size_t>(digits + sizeof(digits) - p);
+    memcpy(buf, p, len);
+    return buf + len;
+}
+
+inline char* writeInt64(int64_t i, char* buf) {
+    auto u = static_cast<uint64_t>(i);
+    if (i < 0) {
+        *buf++ = '-';
+        u = 0 - u;
+    }
+    return writeUint64(u, buf);
+}
+
+// The shortest representation which reads back as the same double (std::to_chars implements Ryu),
+// with ".0" appended when it would otherwise read back as an integer. d must be finite.
+inline char* writeDouble(double d, char* buf) {
+    char* end = std::to_chars(buf, buf + MAX_NUMBER_LENGTH, d).ptr;
+    auto len = static_cast<size_t>(end - buf);
+    if (memchr(buf, '.', len) == nullptr && memchr(buf, 'e', len) == nullptr) {
+        memcpy(end, ".0", 2);
+        end += 2;
+    }
+    return end;
+}
+
+}  // namespace json::number
+
+#endif  // TINY_JSON_NUMBER_H
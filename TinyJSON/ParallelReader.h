@@ -0,0 +1,266 @@
+#ifndef TINY_JSON_PARALLEL_READER_H
+#define TINY_JSON_PARALLEL_READER_H
+
+#include "Document.h"
+#include "Exception.h"
+#include "Reader.h"
+#include "ReadStream.h"
+#include "Simd.h"
+#include "StructuralReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace json
+{
+
+// Parses large inputs on several threads. The input is split into batches which are parsed
+// independently, each with its own Reader and handler, by workers that take the next batch when done.
+class ParallelReader : noncopyable
+{
+public:
+    // One line of newline-delimited JSON (NDJSON, JSON Lines)
+    struct Line
+    {
+        size_t number = 0;    // 0-based line number in the input
+        ParseResult result;   // the offset is relative to the start of the line
+        Document document;
+    };
+
+    // Call fn(number, line) for every line which is not blank, on "threads" workers, 0 for one per core.
+    // Lines are visited in input order within a batch, batches in no particular order,
+    // so fn must be safe to call from several threads at once. A trailing '\r' is not part of the line.
+    template<typename Fn>
+    static void forEachLine(std::string_view input, Fn&& fn, unsigned threads = 0) {
+        threads = workerCount(threads);
+        std::vector<std::string_view> batches = splitLines(input, threads);
+
+        // the number of the first line of each batch
+        std::vector<size_t> firstLine(batches.size() + 1, 0);
+        parallelFor(batches.size(), threads, [&](size_t i) {
+            firstLine[i + 1] = static_cast<size_t>(std::count(batches[i].begin(), batches[i].end(), '\n'));
+        });
+        for (size_t i = 0; i < batches.size(); i++) firstLine[i + 1] += firstLine[i];
+
+        parallelFor(batches.size(), threads, [&](size_t i) { visitLines(batches[i], firstLine[i], fn); });
+    }
+
+    // Parse every line which is not blank into its own Document, the lines are returned in input order
+    static std::vector<Line> parseLines(std::string_view input, unsigned threads = 0) {
+        threads = workerCount(threads);
+        std::vector<std::string_view> batches = splitLines(input, threads);
+        std::vector<std::vector<Line>> parsed(batches.size());
+        std::vector<size_t> lineCount(batches.size());
+        parallelFor(batches.size(), threads, [&](size_t i) {
+            // numbered within the batch here, in the whole input below
+            lineCount[i] = visitLines(batches[i], 0, [&](size_t number, std::string_view line) {
+                Line& parsedLine = parsed[i].emplace_back();
+                parsedLine.number = number;
+                parsedLine.result = parsedLine.document.parse(line);
+            });
+        });
+
+        std::vector<Line> lines;
+        size_t total = 0;
+        for (auto& batch: parsed) total += batch.size();
+        lines.reserve(total);
+        size_t firstLine = 0;
+        for (size_t i = 0; i < parsed.size(); i++) {
+            for (auto& line: parsed[i]) {
+                line.number += firstLine;
+                lines.push_back(std::move(line));
+            }
+            parsed[i] = std::vector<Line>();
+            firstLine += lineCount[i];
+        }
+        return lines;
+    }
+
+    // Parse every line which is not blank into its own Document and hand it to callback(Line&&)
+    // on the worker which parsed it, as soon as it is done and in no particular order
+    template<typename Callback>
+    static void parseLinesUnordered(std::string_view input, Callback&& callback, unsigned threads = 0) {
+        forEachLine(input, [&](size_t number, std::string_view line) {
+            Line parsedLine;
+            parsedLine.number = number;
+            parsedLine.result = parsedLine.document.parse(line);
+            callback(std::move(parsedLine));
+        }, threads);
+    }
+
+    // Parse a document which is one large array: a structural pre-scan finds the elements,
+    // workers parse ranges of them into partial documents, whose elements are then moved into the array of doc.
+    // In arena mode each partial document has its own arena, which doc keeps. A memory resource given to doc
+    // is used by all the workers at once, so it must be thread-safe, like std::pmr::synchronized_pool_resource.
+    // Any other input, and any error, is parsed again on the calling thread for the exact error.
+    static ParseResult parseArray(std::string_view input, Document& doc, unsigned threads = 0,
+                                  size_t maxDepth = Reader::DEFAULT_MAX_DEPTH) {
+        threads = workerCount(threads);
+        doc.reset();
+        std::vector<std::string_view> elements;
+        if (threads == 1 || maxDepth == 0 || !splitArray(input, elements)) return parseSequential(input, doc, maxDepth);
+
+        // ranges of about the same number of bytes
+        size_t count = std::clamp<size_t>(input.size() / MIN_BATCH_SIZE, 1, threads * BATCHES_PER_WORKER);
+        size_t size = input.size() / count + 1;
+        std::vector<size_t> rangeStart{0};
+        for (size_t i = 1, bytes = 0; i < elements.size(); i++) {
+            bytes += elements[i - 1].size();
+            if (bytes >= size) {
+                rangeStart.push_back(i);
+                bytes = 0;
+            }
+        }
+        rangeStart.push_back(elements.size());
+
+        size_t ranges = rangeStart.size() - 1;
+        std::vector<Document> parts;
+        parts.reserve(ranges);
+        for (size_t r = 0; r < ranges; r++) {
+            if (doc.userResource) {
+                parts.emplace_back(doc.userResource, doc.ownership, doc.interning, doc.sharedPool);
+            } else {
+                parts.emplace_back(doc.getAllocation(), doc.ownership, doc.interning, doc.sharedPool);
+            }
+        }
+        std::atomic<bool> failed = false;
+        parallelFor(ranges, threads, [&](size_t r) {
+            Document& part = parts[r];
+            part.StartArray();
+            for (size_t i = rangeStart[r]; i < rangeStart[r + 1] && !failed.load(std::memory_order_relaxed); i++) {
+                StringReadStream is(elements[i]);
+                if (Reader::parse(is, part, maxDepth - 1) != PARSE_OK) {
+                    // the element may have left containers open, the part is dropped without closing its array
+                    failed = true;
+                    return;
+                }
+            }
+            part.EndArray();
+        });
+        if (failed) {
+            doc.reset();
+            return parseSequential(input, doc, maxDepth);
+        }
+
+        doc.StartArray();
+        Array& array = doc.getArray();
+        array.reserve(elements.size());
+        for (auto& part: parts) {
+            for (auto& element: part.getArray()) array.push_back(std::move(element));
+            doc.adopt(std::move(part));
+        }
+        doc.EndArray();
+        return ParseResult();
+    }
+
+private:
+    // Find the elements of a top-level array from the structural index of StructuralReader, each without the
+    // separating commas. Returns false if the input is not one array or the brackets don't match up.
+    static bool splitArray(std::string_view input, std::vector<std::string_view>& elements) {
+        if (input.size() > std::numeric_limits<uint32_t>::max()) return false;
+        std::vector<uint32_t> indexes;
+        StructuralReader::buildIndex(input.data(), input.size(), indexes);
+        if (indexes.empty() || input[indexes[0]] != '[') return false;
+
+        size_t depth = 0;
+        size_t start = indexes[0] + 1;
+        for (size_t i = 0; i < indexes.size(); i++) {
+            switch (input[indexes[i]]) {
+                case '[':
+                case '{':
+                    depth++;
+                    break;
+                case ']':
+                case '}':
+                    if (--depth > 0) break;
+                    // the end of the array must be the end of the input
+                    if (input[indexes[i]] != ']' || i + 1 != indexes.size()) return false;
+                    {
+                        std::string_view last = input.substr(start, indexes[i] - start);
+                        // "[ ]" has no elements, but "[1, ]" has an empty one which fails to parse
+                        if (!elements.empty() || simd::skipWhitespace(last.data(), last.data() + last.size()) !=
+                                                 last.data() + last.size()) {
+                            elements.push_back(last);
+                        }
+                    }
+                    return true;
+                case ',':
+                    if (depth == 1) {
+                        elements.push_back(input.substr(start, indexes[i] - start));
+                        start = indexes[i] + 1;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        return false;
+    }
+
+    static ParseResult parseSequential(std::string_view input, Document& doc, size_t maxDepth) {
+        StringReadStream is(input);
+        return doc.parseStream(is, maxDepth);
+    }
+
+    static unsigned workerCount(unsigned threads) {
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        return std::max(threads, 1u);
+    }
+
+    // A few batches per worker evens out lines of different cost
+    static constexpr size_t BATCHES_PER_WORKER = 4;
+    static constexpr size_t MIN_BATCH_SIZE = 64 * 1024;
+
+    // Split the input into batches of whole lines, every batch but the last ends with '\n'
+    static std::vector<std::string_view> splitLines(std::string_view input, unsigned threads) {
+        size_t count = std::clamp<size_t>(input.size() / MIN_BATCH_SIZE, 1, threads * BATCHES_PER_WORKER);
+        size_t size = input.size() / count + 1;
+        std::vector<std::string_view> batches;
+        while (!input.empty()) {
+            size_t eol = size < input.size() ? input.find('\n', size) : std::string_view::npos;
+            size_t len = eol == std::string_view::npos ? input.size() : eol + 1;
+            batches.push_back(input.substr(0, len));
+            input.remove_prefix(len);
+        }
+        return batches;
+    }
+
+    // Call fn(number, line) for every line of the batch which is not blank, return the number of lines
+    template<typename Fn>
+    static size_t visitLines(std::string_view batch, size_t number, Fn&& fn) {
+        size_t first = number;
+        while (!batch.empty()) {
+            size_t eol = batch.find('\n');
+            std::string_view line = batch.substr(0, eol);
+            batch.remove_prefix(eol == std::string_view::npos ? batch.size() : eol + 1);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (simd::skipWhitespace(line.data(), line.data() + line.size()) != line.data() + line.size()) {
+                fn(number, line);
+            }
+            number++;
+        }
+        return number - first;
+    }
+
+    // Call fn(i) for every i in [0, n) on up to "threads" threads, the calling one included
+    template<typename Fn>
+    static void parallelFor(size_t n, unsigned threads, Fn&& fn) {
+        std::atomic<size_t> next = 0;
+        auto work = [&] {
+            for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < n;) fn(i);
+        };
+        std::vector<std::thread> workers;
+        for (size_t t = 1; t < threads && t < n; t++) workers.emplace_back(work);
+        work();
+        for (auto& worker: workers) worker.join();
+    }
+};
+
+}  // namespace json
+
+#endif  // TINY_JSON_PARALLEL_READER_H
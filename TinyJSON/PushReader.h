@@ -0,0 +1,264 @@
+#ifndef TINY_JSON_PUSH_READER_H
+#define TINY_JSON_PUSH_READER_H
+
+#include "Exception.h"
+#include "Reader.h"
+#include "ReadStream.h"
+#include "Simd.h"
+
+#include <string>
+#include <string_view>
+
+namespace json
+{
+
+// An incremental parser for input which arrives in pieces, such as a request body read from a socket.
+// Each feed() sends the handler the events completed so far and keeps the rest of the state,
+// the open containers and a token cut by the end of the chunk, for the next call.
+// It reports the same errors at the same offsets as Reader over the whole input.
+template<typename Handler>
+class PushReader : noncopyable
+{
+public:
+    explicit PushReader(Handler& _handler, size_t maxDepth = Reader::DEFAULT_MAX_DEPTH) : handler(_handler) {
+        ctx.maxDepth = maxDepth;
+    }
+
+    // Parse the next piece of the input. Strings which are complete in the chunk are passed as views into it.
+    // After an error the same error is returned and further input is ignored.
+    ParseResult feed(std::string_view chunk) {
+        if (ctx.error == PARSE_OK) {
+            parseChunk(chunk);
+            consumed += chunk.size();
+        }
+        return result();
+    }
+
+    // Mark the end of the input, which completes a trailing number or literal
+    ParseResult finish() {
+        if (ctx.error != PARSE_OK) return result();
+        if (token != NO_TOKEN && !parseToken(partial)) return result();
+        switch (state) {
+            case EXPECT_VALUE:
+            case ARRAY_START:
+                fail(PARSE_EXPECT_VALUE, consumed);
+                break;
+            case OBJECT_START:
+            case EXPECT_KEY:
+                fail(PARSE_MISS_KEY, consumed);
+                break;
+            case EXPECT_COLON:
+                fail(PARSE_MISS_COLON, consumed);
+                break;
+            case AFTER_VALUE:
+                if (!ctx.levels.empty()) fail(afterValueError(), consumed);
+                break;
+        }
+        return result();
+    }
+
+    // Forget the input so far to parse another document
+    void reset() {
+        size_t maxDepth = ctx.maxDepth;
+        ctx = Reader::Context();
+        ctx.maxDepth = maxDepth;
+        state = EXPECT_VALUE;
+        token = NO_TOKEN;
+        partial.clear();
+        consumed = 0;
+    }
+
+private:
+    enum State { EXPECT_VALUE, ARRAY_START, OBJECT_START, EXPECT_KEY, EXPECT_COLON, AFTER_VALUE };
+
+    // A string value, a key, or a number or literal
+    enum Token { NO_TOKEN, STRING_TOKEN, KEY_TOKEN, SCALAR_TOKEN };
+
+// Fail at p in the current chunk
+#define FAIL(err) return fail(err, offsetOf(p))
+#define CALL(expr) \
+    if (!(expr)) FAIL(PARSE_USER_STOPPED)
+
+    bool parseChunk(std::string_view chunk) {
+        const char* p = chunk.data();
+        const char* end = p + chunk.size();
+        auto offsetOf = [&](const char* pos) { return consumed + static_cast<size_t>(pos - chunk.data()); };
+
+        // Find the end of the token at p, parse it at once if it is complete or keep it for the next chunk
+        auto startToken = [&](Token kind) {
+            token = kind;
+            tokenOffset = offsetOf(p);
+            escaped = false;
+            bool complete;
+            const char* tokenEnd = findTokenEnd(kind == SCALAR_TOKEN ? p : p + 1, end, complete);
+            if (!complete) {
+                partial.assign(p, end);
+                p = end;
+                return true;
+            }
+            if (!parseToken(std::string_view(p, static_cast<size_t>(tokenEnd - p)))) return false;
+            p = tokenEnd;
+            return true;
+        };
+
+        if (token != NO_TOKEN) {
+            bool complete;
+            const char* tokenEnd = findTokenEnd(p, end, complete);
+            partial.append(p, tokenEnd);
+            if (!complete) return true;
+            if (!parseToken(partial)) return false;
+            p = tokenEnd;
+        }
+
+        while (true) {
+            p = simd::skipWhitespace(p, end);
+            if (p == end) return true;
+
+            switch (state) {
+                case ARRAY_START:
+                    if (*p == ']') {
+                        ctx.levels.pop();
+                        p++;
+                        CALL(handler.EndArray());
+                        state = AFTER_VALUE;
+                        break;
+                    }
+                    [[fallthrough]];
+                case EXPECT_VALUE:
+                    switch (*p) {
+                        case '[':
+                            if (ctx.levels.depth() >= ctx.maxDepth) FAIL(PARSE_DEPTH_EXCEEDED);
+                            CALL(handler.StartArray());
+                            ctx.levels.push(false);
+                            p++;
+                            state = ARRAY_START;
+                            break;
+                        case '{':
+                            if (ctx.levels.depth() >= ctx.maxDepth) FAIL(PARSE_DEPTH_EXCEEDED);
+                            CALL(handler.StartObject());
+                            ctx.levels.push(true);
+                            p++;
+                            state = OBJECT_START;
+                            break;
+                        default:
+                            if (!startToken(*p == '"' ? STRING_TOKEN : SCALAR_TOKEN)) return false;
+                            break;
+                    }
+                    break;
+
+                case OBJECT_START:
+                    if (*p == '}') {
+                        ctx.levels.pop();
+                        p++;
+                        CALL(handler.EndObject());
+                        state = AFTER_VALUE;
+                        break;
+                    }
+                    [[fallthrough]];
+                case EXPECT_KEY:
+                    if (*p != '"') FAIL(PARSE_MISS_KEY);
+                    if (!startToken(KEY_TOKEN)) return false;
+                    break;
+
+                case EXPECT_COLON:
+                    if (*p != ':') FAIL(PARSE_MISS_COLON);
+                    p++;
+                    state = EXPECT_VALUE;
+                    break;
+
+                case AFTER_VALUE:
+                    if (ctx.levels.empty()) FAIL(PARSE_ROOT_NOT_SINGULAR);
+                    if (*p == ',') {
+                        p++;
+                        state = ctx.levels.inObject() ? EXPECT_KEY : EXPECT_VALUE;
+                    } else if (*p == (ctx.levels.inObject() ? '}' : ']')) {
+                        bool isObject = ctx.levels.inObject();
+                        ctx.levels.pop();
+                        p++;
+                        CALL(isObject ? handler.EndObject() : handler.EndArray());
+                    } else {
+                        FAIL(afterValueError());
+                    }
+                    break;
+            }
+        }
+    }
+
+#undef CALL
+#undef FAIL
+
+    // Return the end of the current token in [p, end), and whether it ends there or continues in the next chunk.
+    // A string ends after its closing quote, which may follow an escape in an earlier chunk;
+    // a number or literal ends before whitespace or a structural character.
+    const char* findTokenEnd(const char* p, const char* end, bool& complete) {
+        complete = true;
+        if (token == SCALAR_TOKEN) {
+            while (p != end && !isDelimiter(*p)) p++;
+            complete = p != end;
+            return p;
+        }
+        while (p != end) {
+            if (escaped) {
+                escaped = false;
+                p++;
+                continue;
+            }
+            p = simd::scanString(p, end);
+            if (p == end) break;
+            if (*p == '"') return p + 1;
+            escaped = *p == '\\';
+            p++;
+        }
+        complete = false;
+        return end;
+    }
+
+    static bool isDelimiter(char ch) {
+        switch (ch) {
+            case ',': case ':': case '[': case ']': case '{': case '}': case '"':
+                return true;
+            default:
+                return simd::isWhitespace(ch);
+        }
+    }
+
+    // Parse a whole token with the scalar routines of Reader,
+    // what is left of a number or literal token is an error after a value
+    bool parseToken(std::string_view text) {
+        Token kind = token;
+        token = NO_TOKEN;
+        StringReadStream is(text);
+        if (!(kind == KEY_TOKEN ? Reader::parseString(is, handler, true, ctx) : Reader::parseScalar(is, handler, ctx))) {
+            ctx.offset += tokenOffset;
+            return false;
+        }
+        if (is.hasNext()) return fail(afterValueError(), tokenOffset + is.tell());
+        state = kind == KEY_TOKEN ? EXPECT_COLON : AFTER_VALUE;
+        return true;
+    }
+
+    ParseError afterValueError() const {
+        if (ctx.levels.empty()) return PARSE_ROOT_NOT_SINGULAR;
+        return ctx.levels.inObject() ? PARSE_MISS_COMMA_OR_CURLY_BRACKET : PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
+    }
+
+    bool fail(ParseError err, size_t offset) { return Reader::fail(ctx, err, offset); }
+
+    [[nodiscard]] ParseResult result() const {
+        return ctx.error == PARSE_OK ? ParseResult() : ParseResult(ctx.error, ctx.offset);
+    }
+
+private:
+    Handler& handler;
+    Reader::Context ctx;  // the open containers and the first error
+    State state = EXPECT_VALUE;
+    Token token = NO_TOKEN;    // the kind of the token cut by the end of the last chunk
+    std::string partial;       // its bytes so far
+    size_t tokenOffset = 0;    // its offset in the input
+    bool escaped = false;      // whether the last chunk ended with an escaping backslash inside a string
+    size_t consumed = 0;       // bytes fed before the current chunk
+};
+
+}  // namespace json
+
+#endif  // TINY_JSON_PUSH_READER_H
@@ -3,14 +3,41 @@
 
 #include "noncopyable.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <concepts>
 #include <cstdio>
+#include <cstring>
 #include <cassert>
+#include <ranges>
+#include <span>
+#include <type_traits>
 #include <vector>
 #include <string_view>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace json
 {
 
+// What Reader needs from a stream. getPos() and getEnd() delimit the bytes in memory, which Reader scans in bulk.
+// A stream over part of the input refills them in hasNext(), peek() and next() when they run out,
+// and has fill() to extend them without dropping the unread bytes, see ChunkedReadStream.
+template<typename T>
+concept ReadableStream = requires(T is, const char* pos) {
+    { is.hasNext() } -> std::same_as<bool>;
+    { is.peek() } -> std::same_as<char>;
+    { is.next() } -> std::same_as<char>;
+    { is.tell() } -> std::same_as<size_t>;
+    { is.getPos() } -> std::same_as<const char*>;
+    { is.getEnd() } -> std::same_as<const char*>;
+    is.setPos(pos);
+    is.assertNext('\0');
+};
+
 template<typename BUFFER_TYPE> requires std::ranges::contiguous_range<BUFFER_TYPE>
 class ReadStream : noncopyable
 {
@@ -19,7 +46,7 @@ public:
     using Iterator = BUFFER_TYPE::iterator;
 
 public:
-    ReadStream() = default;
+    ReadStream() : iter(std::ranges::begin(buffer)) {}
 
     explicit ReadStream(BUFFER_TYPE _json) : buffer(_json), iter(_json.begin()) {}
 
@@ -38,6 +65,26 @@ public:
 
     [[nodiscard]] Iterator getIter() const { return iter; }
 
+    // Number of bytes consumed so far
+    [[nodiscard]] size_t tell() const { return static_cast<size_t>(iter - std::ranges::begin(buffer)); }
+
+    // Raw view of the unread input, so that Reader can scan it in bulk
+    [[nodiscard]] const char* getPos() const { return std::ranges::data(buffer) + (iter - std::ranges::begin(buffer)); }
+
+    [[nodiscard]] const char* getEnd() const { return std::ranges::data(buffer) + std::ranges::size(buffer); }
+
+    // Only for streams over a mutable buffer, which Reader parses in situ:
+    // strings are unescaped over their own source bytes and passed to the handler as views into the buffer
+    [[nodiscard]] char* getMutablePos()
+    requires (!std::is_const_v<std::remove_reference_t<std::ranges::range_reference_t<BUFFER_TYPE>>>) {
+        return std::ranges::data(buffer) + (iter - std::ranges::begin(buffer));
+    }
+
+    void setPos(const char* pos) {
+        assert(pos >= getPos() && pos <= getEnd());
+        iter += pos - getPos();
+    }
+
     void assertNext(char ch) {
         assert(peek() == ch);
         next();
@@ -54,6 +101,15 @@ public:
     explicit StringReadStream(std::string_view _json) : ReadStream(_json) {}
 };
 
+// Parses a buffer the caller owns in situ, the buffer is modified
+// and must outlive every string_view the handler received
+class InsituStringStream : public ReadStream<std::span<char>>
+{
+public:
+    explicit InsituStringStream(std::span<char> _json) : ReadStream(_json) {}
+};
+
+// Owns a copy of the whole input, which is parsed in situ
 class FileReadStream : public ReadStream<std::vector<char>>
 {
 public:
@@ -74,6 +130,144 @@ private:
     }
 };
 
+// Reads a FILE or a file descriptor through a fixed-size buffer that is refilled as it is consumed,
+// so that input of any size is parsed in constant memory. Reader assembles strings which span refills
+// in its own buffer; a number has to be in the buffer in one piece, which grows for a longer one.
+class ChunkedReadStream : noncopyable
+{
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 256 * 1024;
+
+    explicit ChunkedReadStream(FILE* _input, size_t bufferSize = DEFAULT_BUFFER_SIZE)
+            : input(_input), buffer(std::max<size_t>(bufferSize, 1)) {}
+
+    // The caller keeps the ownership of fd
+    explicit ChunkedReadStream(int _fd, size_t bufferSize = DEFAULT_BUFFER_SIZE)
+            : fd(_fd), buffer(std::max<size_t>(bufferSize, 1)) {}
+
+    [[nodiscard]] bool hasNext() { return pos != end || fill(); }
+
+    [[nodiscard]] char peek() { return hasNext() ? buffer[pos] : '\0'; }
+
+    char next() { return hasNext() ? buffer[pos++] : '\0'; }
+
+    [[nodiscard]] size_t tell() const { return consumed + pos; }
+
+    [[nodiscard]] const char* getPos() const { return buffer.data() + pos; }
+
+    [[nodiscard]] const char* getEnd() const { return buffer.data() + end; }
+
+    void setPos(const char* p) {
+        assert(p >= getPos() && p <= getEnd());
+        pos = static_cast<size_t>(p - buffer.data());
+    }
+
+    void assertNext(char ch) {
+        assert(peek() == ch);
+        next();
+    }
+
+    // Read more input after the unread bytes, which move to the front of the buffer.
+    // Returns false at the end of the input. Invalidates getPos() and getEnd().
+    bool fill() {
+        if (eof) return false;
+        if (pos > 0) {
+            memmove(buffer.data(), buffer.data() + pos, end - pos);
+            consumed += pos;
+            end -= pos;
+            pos = 0;
+        }
+        // a single number as long as the buffer
+        if (end == buffer.size()) buffer.resize(buffer.size() * 2);
+
+        size_t n = read(buffer.data() + end, buffer.size() - end);
+        if (n == 0) {
+            eof = true;
+            return false;
+        }
+        end += n;
+        return true;
+    }
+
+    // False if reading failed, the input looks truncated to Reader then
+    [[nodiscard]] bool good() const { return ok; }
+
+private:
+    size_t read(char* dst, size_t n) {
+        if (input != nullptr) {
+            size_t got = fread(dst, 1, n, input);
+            if (got == 0 && ferror(input)) ok = false;
+            return got;
+        }
+        while (true) {
+            ssize_t got = ::read(fd, dst, n);
+            if (got >= 0) return static_cast<size_t>(got);
+            if (errno != EINTR) {
+                ok = false;
+                return 0;
+            }
+        }
+    }
+
+private:
+    FILE* input = nullptr;
+    int fd = -1;
+    std::vector<char> buffer;
+    size_t pos = 0;       // next byte to read in buffer
+    size_t end = 0;       // end of the valid bytes in buffer
+    size_t consumed = 0;  // bytes dropped from the front of buffer
+    bool eof = false;
+    bool ok = true;
+};
+
+// Maps a file read-only and reads it in place, without copying it to the heap.
+// The mapping is shared, so processes reading the same file share its pages.
+// Strings without escapes are passed to the handler as views into the mapping,
+// which stays valid as long as the stream is alive.
+class MmapReadStream : public ReadStream<std::string_view>
+{
+public:
+    explicit MmapReadStream(const char* path) {
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        map(fd);
+        close(fd);
+    }
+
+    // The caller keeps the ownership of fd, which may be closed right after construction
+    explicit MmapReadStream(int fd) { map(fd); }
+
+    ~MmapReadStream() {
+        if (data != nullptr) munmap(data, size);
+    }
+
+    // False if the file could not be opened or mapped, the stream is empty then
+    [[nodiscard]] bool good() const { return ok; }
+
+private:
+    void map(int fd) {
+        struct stat st{};
+        if (fstat(fd, &st) < 0) return;
+        size = static_cast<size_t>(st.st_size);
+        // mmap rejects an empty mapping, an empty file is an empty stream
+        if (size > 0) {
+            void* p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED) return;
+            data = p;
+            // Reader consumes the input front to back: read ahead aggressively, drop pages behind
+            madvise(data, size, MADV_SEQUENTIAL);
+            buffer = std::string_view(static_cast<const char*>(data), size);
+        }
+        iter = buffer.begin();
+        ok = true;
+    }
+
+private:
+    void* data = nullptr;
+    size_t size = 0;
+    bool ok = false;
+};
+
 }
 
 #endif //TINY_JSON_READ_STREAM_H
@@ -2,8 +2,10 @@
 #define TINY_JSON_READER_H
 
 #include "Exception.h"
+#include "Number.h"
 #include "Value.h"
 #include "ReadStream.h"
+#include "Simd.h"
 
 #include <cassert>
 #include <cmath>
@@ -12,37 +14,127 @@
 #include <variant>
 #include <vector>
 #include <charconv>
+#include <cstring>
 
 namespace json
 {
 
 class Reader : noncopyable
 {
+    // reuse the scalar routines below
+    friend class StructuralReader;
+    template<typename Handler> friend class PushReader;
+
 public:
+    // Arrays and objects nested deeper than this fail with PARSE_DEPTH_EXCEEDED
+    static constexpr size_t DEFAULT_MAX_DEPTH = 1024;
+
+    struct Context;
+
+    // Errors are reported through the return value, nothing is thrown
     template<typename RS, typename Handler>
-    requires std::is_base_of_v<ReadStream<typename RS::Buffer_Type>, RS>
-    static ParseError parse(RS& is, Handler& handler) {
-        try {
-            parseWhitespace(is);
-            parseValue(is, handler);
-            parseWhitespace(is);
-            if (is.hasNext()) throw Exception(PARSE_ROOT_NOT_SINGULAR);
-            return PARSE_OK;
-        } catch (Exception& e) {
-            return e.err();
-        }
+    requires ReadableStream<RS>
+    static ParseResult parse(RS& is, Handler& handler, size_t maxDepth = DEFAULT_MAX_DEPTH) {
+        Context ctx;
+        return parse(is, handler, ctx, maxDepth);
+    }
+
+    // The same, with the buffers of ctx which are kept for the next parse
+    template<typename RS, typename Handler>
+    requires ReadableStream<RS>
+    static ParseResult parse(RS& is, Handler& handler, Context& ctx, size_t maxDepth = DEFAULT_MAX_DEPTH) {
+        ctx.reset();
+        ctx.maxDepth = maxDepth;
+        size_t start = is.tell();
+        if (parseRoot(is, handler, ctx)) return ParseResult();
+        return ParseResult(ctx.error, ctx.offset - start);
     }
 
 private:
+    // The open arrays and objects, one bit per level which is set for an object
+    class LevelStack
+    {
+    public:
+        [[nodiscard]] size_t depth() const { return size; }
+
+        [[nodiscard]] bool empty() const { return size == 0; }
+
+        [[nodiscard]] bool inObject() const {
+            assert(size > 0);
+            return bits[(size - 1) / 64] >> ((size - 1) % 64) & 1;
+        }
+
+        void push(bool isObject) {
+            if (size / 64 == bits.size()) bits.push_back(0);
+            uint64_t bit = uint64_t{1} << (size % 64);
+            if (isObject) bits[size / 64] |= bit;
+            else bits[size / 64] &= ~bit;
+            size++;
+        }
+
+        void pop() {
+            assert(size > 0);
+            size--;
+        }
+
+        void clear() { size = 0; }
+
+    private:
+        std::vector<uint64_t> bits;
+        size_t size = 0;
+    };
+
+public:
+    // State of one parse. A caller parsing many inputs can keep one, so that its buffers are allocated once.
+    struct Context
+    {
+        std::string scratch;  // holds the strings which have to be unescaped, reused for all of them
+        LevelStack levels;
+        size_t maxDepth = DEFAULT_MAX_DEPTH;
+        ParseError error = PARSE_OK;
+        size_t offset = 0;    // position of the error in the stream
+
+        // Ready for the next parse, with the capacity of the buffers
+        void reset() {
+            scratch.clear();
+            levels.clear();
+            error = PARSE_OK;
+            offset = 0;
+        }
+    };
+
+private:
+    // Record the first error and its position, always returns false
+    static bool fail(Context& ctx, ParseError err, size_t offset) {
+        ctx.error = err;
+        ctx.offset = offset;
+        return false;
+    }
+
+// Fail at the current position, or at the byte just consumed
+#define FAIL(err) return fail(ctx, err, is.tell())
+#define FAIL_BEFORE(err) return fail(ctx, err, is.tell() - 1)
+#define CHECK(expr) \
+    if (!(expr)) return false
 #define CALL(expr) \
-    if (!(expr)) throw Exception(PARSE_USER_STOPPED)
+    if (!(expr)) FAIL(PARSE_USER_STOPPED)
+
+    template<typename RS, typename Handler>
+    requires ReadableStream<RS>
+    static bool parseRoot(RS& is, Handler& handler, Context& ctx) {
+        parseWhitespace(is);
+        CHECK(parseValue(is, handler, ctx));
+        parseWhitespace(is);
+        if (is.hasNext()) FAIL(PARSE_ROOT_NOT_SINGULAR);
+        return true;
+    }
 
     template<typename ReadStream>
-    static unsigned parseHex4(ReadStream& is) {
-        unsigned u = 0;
+    static bool parseHex4(ReadStream& is, Context& ctx, unsigned& u) {
+        u = 0;
         for (int i = 0; i < 4; i++) {
             u <<= 4;
-            switch (char ch = is.next()) {
+            switch (char ch = is.peek()) {
                 case '0' ... '9':
                     u |= static_cast<unsigned>(ch - '0');
                     break;
@@ -53,29 +145,27 @@ private:
                     u |= static_cast<unsigned>(ch - 'A' + 10);
                     break;
                 default:
-                    throw Exception(PARSE_BAD_UNICODE_HEX);
+                    FAIL(PARSE_BAD_UNICODE_HEX);
             }
+            is.next();
         }
-        return u;
+        return true;
     }
 
-    template<typename T>
-    requires std::is_base_of_v<ReadStream<typename T::Buffer_Type>, T>
-    static void parseWhitespace(T& is) {
-        while (is.hasNext()) {
-            char ch = is.peek();
-            if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n') {
-                is.next();
-            } else {
-                break;
-            }
-        }
+    template<typename RS>
+    requires ReadableStream<RS>
+    static void parseWhitespace(RS& is) {
+        // a refilling stream may have more after the end of its buffer
+        do {
+            is.setPos(simd::skipWhitespace(is.getPos(), is.getEnd()));
+        } while (is.getPos() == is.getEnd() && is.hasNext());
     }
 
     template<typename RS, typename Handler>
-    requires std::is_base_of_v<ReadStream<typename RS::Buffer_Type>, RS>
-    static void parseLiteral(RS& is, Handler& handler, const char* literal, ValueType type) {
+    requires ReadableStream<RS>
+    static bool parseLiteral(RS& is, Handler& handler, Context& ctx, const char* literal, ValueType type) {
         char c = *literal;
+        size_t start = is.tell();
 
         is.assertNext(*literal++);
         while (*literal != '\0' && *literal == is.peek()) {
@@ -86,44 +176,75 @@ private:
             switch (type) {
                 case TYPE_NULL:
                     CALL(handler.Null());
-                    return;
+                    return true;
                 case TYPE_BOOL:
                     CALL(handler.Bool(c == 't'));
-                    return;
+                    return true;
                 case TYPE_DOUBLE:
                     CALL(handler.Double(c == 'N' ? NAN : INFINITY));
-                    return;
+                    return true;
                 default:
                     assert(false && "bad type");
             }
         }
-        throw Exception(PARSE_BAD_VALUE);
+        return fail(ctx, PARSE_BAD_VALUE, start);
     }
 
     template<typename RS, typename Handler>
-    requires std::is_base_of_v<ReadStream<typename RS::Buffer_Type>, RS>
-    static void parseNumber(RS& is, Handler& handler) {
+    requires ReadableStream<RS>
+    static bool parseNumber(RS& is, Handler& handler, Context& ctx) {
         // parse 'NaN' (Not a Number) and 'Infinity'
         if (is.peek() == 'N') {
-            parseLiteral(is, handler, "NaN", TYPE_DOUBLE);
-            return;
+            return parseLiteral(is, handler, ctx, "NaN", TYPE_DOUBLE);
         } else if (is.peek() == 'I') {
-            parseLiteral(is, handler, "Infinity", TYPE_DOUBLE);
-            return;
+            return parseLiteral(is, handler, ctx, "Infinity", TYPE_DOUBLE);
         }
 
-        auto start = is.getIter();
+        if constexpr (requires { is.fill(); }) {
+            // the slow path below rescans the number from the buffer, so a refilling stream must hold all of it
+            const char* p = is.getPos();
+            while (true) {
+                while (p != is.getEnd() && isNumberChar(*p)) p++;
+                if (p != is.getEnd()) break;
+                auto scanned = static_cast<size_t>(p - is.getPos());
+                if (!is.fill()) break;
+                p = is.getPos() + scanned;
+            }
+        }
 
-        if (is.peek() == '-') is.next();
+        // Scan and convert in one pass: the first 19 significant digits are accumulated into
+        // "significand", the value is significand * 10^exponent unless digits were dropped
+        const char* start = is.getPos();
+        size_t startOffset = is.tell();
+        bool negative = false;
+        uint64_t significand = 0;
+        int significantDigits = 0;
+        int64_t exponent = 0;
+        bool truncated = false;
+        auto addDigit = [&](char ch, bool isFraction) {
+            if (significantDigits < 19) {
+                significand = significand * 10 + static_cast<unsigned>(ch - '0');
+                if (significand != 0) significantDigits++;
+                if (isFraction) exponent--;
+            } else {
+                if (ch != '0') truncated = true;
+                if (!isFraction) exponent++;
+            }
+        };
+
+        if (is.peek() == '-') {
+            negative = true;
+            is.next();
+        }
 
         if (is.peek() == '0') {
             is.next();
-            if (isdigit(is.peek())) throw Exception(PARSE_BAD_VALUE);
+            if (isDigit(is.peek())) FAIL(PARSE_BAD_VALUE);
         } else if (isDigit19(is.peek())) {
-            is.next();
-            while (isDigit(is.peek())) is.next();
+            addDigit(is.next(), false);
+            while (isDigit(is.peek())) addDigit(is.next(), false);
         } else {
-            throw Exception(PARSE_BAD_VALUE);
+            FAIL(PARSE_BAD_VALUE);
         }
 
         ValueType expectType = TYPE_NULL;
@@ -131,59 +252,66 @@ private:
         if (is.peek() == '.') {
             expectType = TYPE_DOUBLE;
             is.next();
-            if (!isDigit(is.peek())) throw Exception(PARSE_BAD_VALUE);
-            is.next();
-            while (isDigit(is.peek())) is.next();
+            if (!isDigit(is.peek())) FAIL(PARSE_BAD_VALUE);
+            addDigit(is.next(), true);
+            while (isDigit(is.peek())) addDigit(is.next(), true);
         }
         if (is.peek() == 'e' || is.peek() == 'E') {
             expectType = TYPE_DOUBLE;
             is.next();
-            if (is.peek() == '+' || is.peek() == '-') is.next();
-            if (!isDigit(is.peek())) throw Exception(PARSE_BAD_VALUE);
-            is.next();
-            while (isDigit(is.peek())) is.next();
+            bool negativeExponent = false;
+            if (is.peek() == '+' || is.peek() == '-') negativeExponent = is.next() == '-';
+            if (!isDigit(is.peek())) FAIL(PARSE_BAD_VALUE);
+            int64_t e = 0;
+            while (isDigit(is.peek())) {
+                // anything this large over- or underflows, stop before e does
+                if (e < 100000) e = e * 10 + (is.peek() - '0');
+                is.next();
+            }
+            exponent += negativeExponent ? -e : e;
         }
 
         // Whether i32 or i64 is specified
+        const char* end = is.getPos();
         if (is.peek() == 'i') {
+            if (expectType == TYPE_DOUBLE) FAIL(PARSE_BAD_VALUE);
             is.next();
-            if (expectType == TYPE_DOUBLE) throw Exception(PARSE_BAD_VALUE);
             switch (is.next()) {
                 case '3':
-                    if (is.next() != '2') throw Exception(PARSE_BAD_VALUE);
+                    if (is.next() != '2') FAIL_BEFORE(PARSE_BAD_VALUE);
                     expectType = TYPE_INT32;
                     break;
                 case '6':
-                    if (is.next() != '4') throw Exception(PARSE_BAD_VALUE);
+                    if (is.next() != '4') FAIL_BEFORE(PARSE_BAD_VALUE);
                     expectType = TYPE_INT64;
                     break;
                 default:
-                    throw Exception(PARSE_BAD_VALUE);
+                    FAIL_BEFORE(PARSE_BAD_VALUE);
             }
         }
 
-        auto end = is.getIter();
-        if (start == end) throw Exception(PARSE_BAD_VALUE);
-
         if (expectType == TYPE_DOUBLE) {
-            long double d;
-            if (auto res = std::from_chars(&*start, &*end, d);
-                    res.ec != std::errc()
-                    || d > std::numeric_limits<double>::max()
-                    || d < -std::numeric_limits<double>::max()) {
-                throw Exception(PARSE_NUMBER_TOO_BIG);
+            double d;
+            if (truncated || !number::toDouble(significand, exponent, negative, d)) {
+                // the exact but slow conversion, for more than 19 significant digits or a tie
+                // that 128 bits can't decide
+                if (std::from_chars(start, end, d).ec == std::errc::result_out_of_range) {
+                    d = exponent < 0 ? 0.0 : HUGE_VAL;
+                    if (negative) d = -d;
+                }
             }
-            CALL(handler.Double(static_cast<double>(d)));
+            if (std::isinf(d)) return fail(ctx, PARSE_NUMBER_TOO_BIG, startOffset);
+            CALL(handler.Double(d));
         } else {
-            int64_t i64;
-            if (auto res = std::from_chars(&*start, &*end, i64); res.ec != std::errc()) {
-                throw Exception(PARSE_NUMBER_TOO_BIG);
-            }
+            // an integer has no fraction, so "exponent" counts the digits beyond the 19th
+            const uint64_t limit = negative ? uint64_t{1} << 63 : (uint64_t{1} << 63) - 1;
+            if (exponent != 0 || significand > limit) return fail(ctx, PARSE_NUMBER_TOO_BIG, startOffset);
+            auto i64 = static_cast<int64_t>(negative ? 0 - significand : significand);
             if (expectType == TYPE_INT64) {
                 CALL(handler.Int64(i64));
             } else if (expectType == TYPE_INT32) {
                 if (i64 > std::numeric_limits<int32_t>::max() || i64 < std::numeric_limits<int32_t>::min()) {
-                    throw Exception(PARSE_NUMBER_TOO_BIG);
+                    return fail(ctx, PARSE_NUMBER_TOO_BIG, startOffset);
                 }
                 CALL(handler.Int32(static_cast<int32_t>(i64)));
             } else if (i64 <= std::numeric_limits<int32_t>::max() && i64 >= std::numeric_limits<int32_t>::min()) {
@@ -191,26 +319,74 @@ private:
             } else {
                 CALL(handler.Int64(i64));
             }
-
         }
+        return true;
     }
 
     template<typename RS, typename Handler>
-    requires std::is_base_of_v<ReadStream<typename RS::Buffer_Type>, RS>
-    static void parseString(RS& is, Handler& handler, bool isKey) {
+    requires ReadableStream<RS>
+    static bool parseString(RS& is, Handler& handler, bool isKey, Context& ctx) {
         is.assertNext('"');
-        std::string buffer;
-        while (is.hasNext()) {
+        if constexpr (requires { is.getMutablePos(); }) {
+            // in situ: write the unescaped string over its own source bytes, it never gets longer
+            InsituBuffer buffer{is.getMutablePos(), is.getMutablePos()};
+            return parseStringBody(is, handler, isKey, ctx, buffer);
+        } else {
+            // a string without escapes is passed as a view into the input
+            const char* begin = is.getPos();
+            const char* end = simd::scanString(begin, is.getEnd());
+            if (end != is.getEnd() && *end == '"') {
+                is.setPos(end + 1);
+                if (isKey) {
+                    CALL(handler.Key(std::string_view(begin, static_cast<size_t>(end - begin))));
+                } else {
+                    CALL(handler.String(std::string_view(begin, static_cast<size_t>(end - begin))));
+                }
+                return true;
+            }
+            ctx.scratch.assign(begin, end);
+            is.setPos(end);
+            return parseStringBody(is, handler, isKey, ctx, ctx.scratch);
+        }
+    }
+
+    // Destination of an in-situ string, which trails behind the read position
+    struct InsituBuffer
+    {
+        char* begin;
+        char* end;
+
+        void append(const char* first, const char* last) {
+            if (end != first) memmove(end, first, static_cast<size_t>(last - first));
+            end += last - first;
+        }
+
+        void push_back(char ch) { *end++ = ch; }
+
+        explicit operator std::string_view() const { return {begin, static_cast<size_t>(end - begin)}; }
+    };
+
+    template<typename RS, typename Handler, typename Buffer>
+    requires ReadableStream<RS>
+    static bool parseStringBody(RS& is, Handler& handler, bool isKey, Context& ctx, Buffer& buffer) {
+        while (true) {
+            // copy the run of plain characters in bulk, then handle the special one byte at a time
+            const char* begin = is.getPos();
+            const char* end = simd::scanString(begin, is.getEnd());
+            buffer.append(begin, end);
+            is.setPos(end);
+            if (!is.hasNext()) break;
+
             switch (char ch = is.next()) {
                 case '"':
                     if (isKey) {
-                        CALL(handler.Key(std::move(buffer)));
+                        CALL(handler.Key(std::string_view(buffer)));
                     } else {
-                        CALL(handler.String(std::move(buffer)));
+                        CALL(handler.String(std::string_view(buffer)));
                     }
-                    return;
+                    return true;
                 case '\x01' ... '\x1f':
-                    throw Exception(PARSE_BAD_STRING_CHAR);
+                    FAIL_BEFORE(PARSE_BAD_STRING_CHAR);
                 case '\\':
                     switch (is.next()) {
                         case '"':
@@ -238,120 +414,150 @@ private:
                             buffer.push_back('\t');
                             break;
                         case 'u': {
-                            unsigned u = parseHex4(is);
+                            unsigned u;
+                            CHECK(parseHex4(is, ctx, u));
                             if (u >= 0xD800 && u <= 0xDBFF) {
-                                if (is.next() != '\\') throw Exception(PARSE_BAD_UNICODE_SURROGATE);
-                                if (is.next() != 'u') throw Exception(PARSE_BAD_UNICODE_SURROGATE);
-                                unsigned u2 = parseHex4(is);
+                                if (is.next() != '\\') FAIL_BEFORE(PARSE_BAD_UNICODE_SURROGATE);
+                                if (is.next() != 'u') FAIL_BEFORE(PARSE_BAD_UNICODE_SURROGATE);
+                                unsigned u2;
+                                CHECK(parseHex4(is, ctx, u2));
                                 if (u2 >= 0xDC00 && u2 <= 0xDFFF)
                                     u = 0x10000 + (u - 0xD800) * 0x400 + (u2 - 0xDC00);
                                 else
-                                    throw Exception(PARSE_BAD_UNICODE_SURROGATE);
+                                    return fail(ctx, PARSE_BAD_UNICODE_SURROGATE, is.tell() - 4);
                             }
                             encodeUtf8(buffer, u);
                             break;
                         }
                         default:
-                            throw Exception(PARSE_BAD_STRING_ESCAPE);
+                            FAIL_BEFORE(PARSE_BAD_STRING_ESCAPE);
                     }
                     break;
                 default:
                     buffer.push_back(ch);
             }
         }
-        throw Exception(PARSE_MISS_QUOTATION_MARK);
+        FAIL(PARSE_MISS_QUOTATION_MARK);
     }
 
     template<typename RS, typename Handler>
-    requires std::is_base_of_v<ReadStream<typename RS::Buffer_Type>, RS>
-    static void parseArray(RS& is, Handler& handler) {
-        CALL(handler.StartArray());
-
-        is.assertNext('[');
-        parseWhitespace(is);
-        if (is.peek() == ']') {
-            is.next();
-            CALL(handler.EndArray());
-            return;
-        }
-
-        while (true) {
-            parseValue(is, handler);
-            parseWhitespace(is);
-            switch (is.next()) {
-                case ',':
-                    parseWhitespace(is);
-                    break;
-                case ']':
-                    CALL(handler.EndArray());
-                    return;
-                default:
-                    throw Exception(PARSE_MISS_COMMA_OR_SQUARE_BRACKET);
-            }
+    requires ReadableStream<RS>
+    static bool parseScalar(RS& is, Handler& handler, Context& ctx) {
+        switch (is.peek()) {
+            case 'n':
+                return parseLiteral(is, handler, ctx, "null", TYPE_NULL);
+            case 't':
+                return parseLiteral(is, handler, ctx, "true", TYPE_BOOL);
+            case 'f':
+                return parseLiteral(is, handler, ctx, "false", TYPE_BOOL);
+            case '"':
+                return parseString(is, handler, false, ctx);
+            default:
+                return parseNumber(is, handler, ctx);
         }
     }
 
+    // Arrays and objects are parsed by a loop over an explicit stack instead of recursion,
+    // so the nesting depth is bounded by ctx.maxDepth and not by the size of the call stack
     template<typename RS, typename Handler>
-    requires std::is_base_of_v<ReadStream<typename RS::Buffer_Type>, RS>
-    static void parseObject(RS& is, Handler& handler) {
-        CALL(handler.StartObject());
-
-        is.assertNext('{');
-        parseWhitespace(is);
-        if (is.peek() == '}') {
-            is.next();
-            CALL(handler.EndObject());
-            return;
-        }
+    requires ReadableStream<RS>
+    static bool parseValue(RS& is, Handler& handler, Context& ctx) {
+        enum State { EXPECT_VALUE, EXPECT_KEY, AFTER_VALUE };
 
+        LevelStack& levels = ctx.levels;
+        State state = EXPECT_VALUE;
         while (true) {
-            if (is.peek() != '"') throw Exception(PARSE_MISS_KEY);
-
-            parseString(is, handler, true);
+            switch (state) {
+                case EXPECT_VALUE:
+                    if (!is.hasNext()) FAIL(PARSE_EXPECT_VALUE);
+                    switch (is.peek()) {
+                        case '[':
+                            if (levels.depth() >= ctx.maxDepth) FAIL(PARSE_DEPTH_EXCEEDED);
+                            CALL(handler.StartArray());
+                            is.next();
+                            parseWhitespace(is);
+                            if (is.peek() == ']') {
+                                is.next();
+                                CALL(handler.EndArray());
+                                state = AFTER_VALUE;
+                            } else {
+                                levels.push(false);
+                            }
+                            break;
+                        case '{':
+                            if (levels.depth() >= ctx.maxDepth) FAIL(PARSE_DEPTH_EXCEEDED);
+                            CALL(handler.StartObject());
+                            is.next();
+                            parseWhitespace(is);
+                            if (is.peek() == '}') {
+                                is.next();
+                                CALL(handler.EndObject());
+                                state = AFTER_VALUE;
+                            } else {
+                                levels.push(true);
+                                state = EXPECT_KEY;
+                            }
+                            break;
+                        default:
+                            CHECK(parseScalar(is, handler, ctx));
+                            state = AFTER_VALUE;
+                            break;
+                    }
+                    break;
 
-            parseWhitespace(is);
-            if (is.next() != ':') throw Exception(PARSE_MISS_COLON);
-            parseWhitespace(is);
+                case EXPECT_KEY:
+                    if (is.peek() != '"') FAIL(PARSE_MISS_KEY);
+                    CHECK(parseString(is, handler, true, ctx));
+                    parseWhitespace(is);
+                    if (is.peek() != ':') FAIL(PARSE_MISS_COLON);
+                    is.next();
+                    parseWhitespace(is);
+                    state = EXPECT_VALUE;
+                    break;
 
-            parseValue(is, handler);
-            parseWhitespace(is);
-            switch (is.next()) {
-                case ',':
+                case AFTER_VALUE:
+                    if (levels.empty()) return true;
                     parseWhitespace(is);
+                    if (!levels.inObject()) {
+                        switch (is.peek()) {
+                            case ',':
+                                is.next();
+                                parseWhitespace(is);
+                                state = EXPECT_VALUE;
+                                break;
+                            case ']':
+                                is.next();
+                                levels.pop();
+                                CALL(handler.EndArray());
+                                break;
+                            default:
+                                FAIL(PARSE_MISS_COMMA_OR_SQUARE_BRACKET);
+                        }
+                    } else {
+                        switch (is.peek()) {
+                            case ',':
+                                is.next();
+                                parseWhitespace(is);
+                                state = EXPECT_KEY;
+                                break;
+                            case '}':
+                                is.next();
+                                levels.pop();
+                                CALL(handler.EndObject());
+                                break;
+                            default:
+                                FAIL(PARSE_MISS_COMMA_OR_CURLY_BRACKET);
+                        }
+                    }
                     break;
-                case '}':
-                    CALL(handler.EndObject());
-                    return;
-                default:
-                    throw Exception(PARSE_MISS_COMMA_OR_CURLY_BRACKET);
             }
         }
     }
 
 #undef CALL
-
-    template<typename RS, typename Handler>
-    requires std::is_base_of_v<ReadStream<typename RS::Buffer_Type>, RS>
-    static void parseValue(RS& is, Handler& handler) {
-        if (!is.hasNext()) throw Exception(PARSE_EXPECT_VALUE);
-
-        switch (is.peek()) {
-            case 'n':
-                return parseLiteral(is, handler, "null", TYPE_NULL);
-            case 't':
-                return parseLiteral(is, handler, "true", TYPE_BOOL);
-            case 'f':
-                return parseLiteral(is, handler, "false", TYPE_BOOL);
-            case '"':
-                return parseString(is, handler, false);
-            case '[':
-                return parseArray(is, handler);
-            case '{':
-                return parseObject(is, handler);
-            default:
-                return parseNumber(is, handler);
-        }
-    }
+#undef CHECK
+#undef FAIL_BEFORE
+#undef FAIL
 
 private:
 
@@ -359,7 +565,13 @@ private:
 
     static bool isDigit19(char ch) { return ch >= '1' && ch <= '9'; }
 
-    static void encodeUtf8(std::string& buffer, unsigned u) {
+    // Including the i32 and i64 suffixes
+    static bool isNumberChar(char ch) {
+        return isDigit(ch) || ch == '-' || ch == '+' || ch == '.' || ch == 'e' || ch == 'E' || ch == 'i';
+    }
+
+    template<typename Buffer>
+    static void encodeUtf8(Buffer& buffer, unsigned u) {
         switch (u) {
             case 0x00 ... 0x7F:
                 buffer.push_back(static_cast<char>(u & 0xFF));
@@ -0,0 +1,180 @@
+#ifndef TINY_JSON_SIMD_H
+#define TINY_JSON_SIMD_H
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE4_2__) || defined(__PCLMUL__)
+#include <immintrin.h>
+#endif
+
+namespace json::simd
+{
+
+// Kernels used by Reader and Writer to scan contiguous input 32 (AVX2) or 16 (SSE4.2) bytes at a time.
+// Each kernel only loads full blocks inside [p, end) and finishes the tail with the scalar loop,
+// so it never reads past the end of the buffer.
+
+inline bool isWhitespace(char ch) { return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n'; }
+
+// The bytes that end a plain run inside a string: '"', '\\' and control characters (< 0x20)
+inline bool isStringSpecial(char ch) {
+    return ch == '"' || ch == '\\' || static_cast<unsigned char>(ch) < 0x20;
+}
+
+// Return the first non-whitespace byte in [p, end), or end
+inline const char* skipWhitespace(const char* p, const char* end) {
+    // Most tokens are separated by no or a single whitespace byte, don't pay for a vector load then
+    if (p == end || !isWhitespace(*p)) return p;
+    if (++p == end || !isWhitespace(*p)) return p;
+
+#if defined(__AVX2__)
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab)),
+                                     _mm256_or_si256(_mm256_cmpeq_epi8(v, cr), _mm256_cmpeq_epi8(v, lf)));
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(ws));
+        if (mask != 0xFFFFFFFFu) return p + std::countr_one(mask);
+    }
+#elif defined(__SSE4_2__)
+    alignas(16) static const char whitespace[16] = {' ', '\t', '\r', '\n'};
+    const __m128i ws = _mm_load_si128(reinterpret_cast<const __m128i*>(whitespace));
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int i = _mm_cmpestri(ws, 4, v, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY |
+                                           _SIDD_LEAST_SIGNIFICANT | _SIDD_NEGATIVE_POLARITY);
+        if (i != 16) return p + i;
+    }
+#endif
+
+    while (p != end && isWhitespace(*p)) p++;
+    return p;
+}
+
+// Return the first '"', '\\' or control character in [p, end), or end
+inline const char* scanString(const char* p, const char* end) {
+#if defined(__AVX2__)
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(0x1F);
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        // max(v, 0x1F) == 0x1F <=> v <= 0x1F as unsigned bytes
+        __m256i special = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)),
+                _mm256_cmpeq_epi8(_mm256_max_epu8(v, control), control));
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+        if (mask != 0) return p + std::countr_zero(mask);
+    }
+#elif defined(__SSE4_2__)
+    alignas(16) static const char ranges[16] = {'\0', '\x1F', '"', '"', '\\', '\\'};
+    const __m128i r = _mm_load_si128(reinterpret_cast<const __m128i*>(ranges));
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int i = _mm_cmpestri(r, 6, v, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+        if (i != 16) return p + i;
+    }
+#endif
+
+    while (p != end && !isStringSpecial(*p)) p++;
+    return p;
+}
+
+// Bitmasks of one 64-byte block, bit i describes byte i
+struct BlockMasks
+{
+    uint64_t quote;       // '"'
+    uint64_t backslash;   // '\\'
+    uint64_t op;          // '{', '}', '[', ']', ':' and ','
+    uint64_t whitespace;  // ' ', '\t', '\r' and '\n'
+};
+
+inline BlockMasks classify(const char* p) {
+    BlockMasks m{};
+#if defined(__AVX2__)
+    auto eq = [](__m256i v, char c) { return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)); };
+    auto bits = [](__m256i lo, __m256i hi) {
+        return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(lo))) |
+               static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hi))) << 32;
+    };
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    m.quote = bits(eq(lo, '"'), eq(hi, '"'));
+    m.backslash = bits(eq(lo, '\\'), eq(hi, '\\'));
+    // '[' | 0x20 == '{' and ']' | 0x20 == '}', so two compares cover four brackets
+    const __m256i lower = _mm256_set1_epi8(0x20);
+    auto op = [&](__m256i v) {
+        __m256i folded = _mm256_or_si256(v, lower);
+        return _mm256_or_si256(_mm256_or_si256(eq(folded, '{'), eq(folded, '}')),
+                               _mm256_or_si256(eq(v, ':'), eq(v, ',')));
+    };
+    m.op = bits(op(lo), op(hi));
+    auto ws = [&](__m256i v) {
+        return _mm256_or_si256(_mm256_or_si256(eq(v, ' '), eq(v, '\t')), _mm256_or_si256(eq(v, '\r'), eq(v, '\n')));
+    };
+    m.whitespace = bits(ws(lo), ws(hi));
+#elif defined(__SSE4_2__)
+    auto eq = [](__m128i v, char c) { return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); };
+    const __m128i lower = _mm_set1_epi8(0x20);
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        __m128i folded = _mm_or_si128(v, lower);
+        auto bits = [&](__m128i x) {
+            return static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(x))) << (16 * i);
+        };
+        m.quote |= bits(eq(v, '"'));
+        m.backslash |= bits(eq(v, '\\'));
+        m.op |= bits(_mm_or_si128(_mm_or_si128(eq(folded, '{'), eq(folded, '}')),
+                                  _mm_or_si128(eq(v, ':'), eq(v, ','))));
+        m.whitespace |= bits(_mm_or_si128(_mm_or_si128(eq(v, ' '), eq(v, '\t')),
+                                          _mm_or_si128(eq(v, '\r'), eq(v, '\n'))));
+    }
+#else
+    for (int i = 0; i < 64; i++) {
+        uint64_t bit = uint64_t{1} << i;
+        switch (p[i]) {
+            case '"':
+                m.quote |= bit;
+                break;
+            case '\\':
+                m.backslash |= bit;
+                break;
+            case '{': case '}': case '[': case ']': case ':': case ',':
+                m.op |= bit;
+                break;
+            case ' ': case '\t': case '\r': case '\n':
+                m.whitespace |= bit;
+                break;
+            default:
+                break;
+        }
+    }
+#endif
+    return m;
+}
+
+// Bit i of the result is the xor of bits 0..i of the argument, which turns a mask of quotes
+// into a mask of the bytes between them
+inline uint64_t prefixXor(uint64_t bits) {
+#if defined(__PCLMUL__)
+    __m128i all = _mm_set1_epi8(static_cast<char>(0xFF));
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_clmulepi64_si128(
+            _mm_set_epi64x(0, static_cast<long long>(bits)), all, 0)));
+#else
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+#endif
+}
+
+}  // namespace json::simd
+
+#endif  // TINY_JSON_SIMD_H
@@ -0,0 +1,64 @@
+#ifndef TINY_JSON_STRING_POOL_H
+#define TINY_JSON_STRING_POOL_H
+
+#include "Value.h"
+
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <unordered_map>
+
+namespace json
+{
+
+// A set of strings, each stored once and handed out as the same StringPtr.
+// Document uses one to share the keys, and optionally the short string values, which repeat
+// in every record of an array. A pooled string is shared by every value which uses it,
+// so it must not be modified in place.
+//
+// A pool built up front can also be shared by several documents as a std::shared_ptr<const StringPool>,
+// they only look strings up in it, which is safe from several threads.
+class StringPool : noncopyable
+{
+public:
+    // Strings this long or shorter are pooled as values, longer ones rarely repeat.
+    // Those up to Value::SHORT_STRING_LENGTH are stored inline by Document and never pooled.
+    static constexpr size_t MAX_VALUE_LENGTH = 32;
+    // Stop adding strings after this many, a document of unique keys should not grow a large pool
+    static constexpr size_t DEFAULT_MAX_SIZE = 4096;
+
+    explicit StringPool(std::pmr::memory_resource* _resource = std::pmr::get_default_resource(),
+                        size_t _maxSize = DEFAULT_MAX_SIZE)
+            : resource(_resource), strings(_resource), maxSize(_maxSize) {}
+
+    // The pooled string equal to s, nullptr if there is none
+    [[nodiscard]] const StringPtr* find(std::string_view s) const {
+        auto it = strings.find(s);
+        return it == strings.end() ? nullptr : &it->second;
+    }
+
+    // The pooled string equal to s, added if there is none and the pool is not full.
+    // An empty pointer when the pool is full.
+    StringPtr intern(std::string_view s) {
+        if (const StringPtr* found = find(s)) return *found;
+        if (strings.size() >= maxSize) return nullptr;
+        auto str = StringPtr::make(resource, s);
+        // the key views the pooled string, which never changes
+        strings.emplace(std::string_view(*str), str);
+        return str;
+    }
+
+    [[nodiscard]] size_t size() const { return strings.size(); }
+
+    // Drop every string, the memory of the table goes back to the resource
+    void clear() { strings = std::pmr::unordered_map<std::string_view, StringPtr>(resource); }
+
+private:
+    std::pmr::memory_resource* resource;
+    std::pmr::unordered_map<std::string_view, StringPtr> strings;
+    size_t maxSize;
+};
+
+}  // namespace json
+
+#endif  // TINY_JSON_STRING_POOL_H
@@ -0,0 +1,225 @@
+#ifndef TINY_JSON_STRUCTURAL_READER_H
+#define TINY_JSON_STRUCTURAL_READER_H
+
+#include "Exception.h"
+#include "Reader.h"
+#include "ReadStream.h"
+#include "Simd.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace json
+{
+
+// A two-stage parser for contiguous input, an alternative to the recursive descent of Reader.
+// Stage one finds the offset of every structural character ('{', '}', '[', ']', ':', ','),
+// the start of every string and the start of every other scalar, 64 bytes at a time.
+// Stage two walks that index and drives the same Handler concept as Reader.
+class StructuralReader : noncopyable
+{
+public:
+    template<typename RS, typename Handler>
+    requires std::is_base_of_v<ReadStream<typename RS::Buffer_Type>, RS>
+    static ParseResult parse(RS& is, Handler& handler, size_t maxDepth = Reader::DEFAULT_MAX_DEPTH) {
+        const char* json = is.getPos();
+        const char* end = is.getEnd();
+        auto len = static_cast<size_t>(end - json);
+        // offsets are 32 bits wide
+        if (len > std::numeric_limits<uint32_t>::max()) return Reader::parse(is, handler, maxDepth);
+
+        Reader::Context ctx;
+        ctx.maxDepth = maxDepth;
+        std::vector<uint32_t> indexes;
+        buildIndex(json, len, indexes);
+        if (!walkIndex(json, end, indexes, handler, ctx)) return ParseResult(ctx.error, ctx.offset);
+        is.setPos(end);
+        return ParseResult();
+    }
+
+    // Stage one: fill "indexes" with the offsets of the structural characters of json[0, len)
+    static void buildIndex(const char* json, size_t len, std::vector<uint32_t>& indexes) {
+        indexes.clear();
+
+        uint64_t prevEscaped = 0;   // whether the first byte of the next block is escaped
+        uint64_t prevInString = 0;  // all ones if the previous block ended inside a string
+        uint64_t prevScalar = 0;    // whether the previous block ended with a non-quote scalar byte
+
+        for (size_t offset = 0; offset < len; offset += 64) {
+            const char* block = json + offset;
+            char tail[64];
+            if (len - offset < 64) {
+                memset(tail, ' ', sizeof(tail));
+                memcpy(tail, block, len - offset);
+                block = tail;
+            }
+
+            simd::BlockMasks m = simd::classify(block);
+
+            uint64_t quote = m.quote & ~findEscaped(m.backslash, prevEscaped);
+            // set from an opening quote up to, but not including, its closing quote
+            uint64_t inString = simd::prefixXor(quote) ^ prevInString;
+            prevInString = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+
+            // a scalar (string, number or literal) starts at a non-blank byte which does not follow another one
+            uint64_t scalar = ~(m.op | m.whitespace);
+            uint64_t nonQuoteScalar = scalar & ~quote;
+            uint64_t followsNonQuoteScalar = (nonQuoteScalar << 1) | prevScalar;
+            prevScalar = nonQuoteScalar >> 63;
+
+            uint64_t structurals = (m.op | (scalar & ~followsNonQuoteScalar)) & ~(inString ^ quote);
+
+            size_t n = indexes.size();
+            indexes.resize(n + static_cast<size_t>(std::popcount(structurals)));
+            for (; structurals != 0; structurals &= structurals - 1) {
+                indexes[n++] = static_cast<uint32_t>(offset + static_cast<size_t>(std::countr_zero(structurals)));
+            }
+        }
+    }
+
+private:
+// Fail at the current index
+#define FAIL(err) return Reader::fail(ctx, err, i < n ? indexes[i] : static_cast<size_t>(end - json))
+#define CALL(expr) \
+    if (!(expr)) FAIL(PARSE_USER_STOPPED)
+
+    // Return the mask of bytes escaped by a backslash, odd-length backslash runs escape the next byte
+    static uint64_t findEscaped(uint64_t backslash, uint64_t& prevEscaped) {
+        backslash &= ~prevEscaped;
+        uint64_t followsEscape = (backslash << 1) | prevEscaped;
+
+        const uint64_t evenBits = 0x5555555555555555ULL;
+        uint64_t oddSequenceStarts = backslash & ~evenBits & ~followsEscape;
+        uint64_t sequencesStartingOnEvenBits;
+        prevEscaped = __builtin_add_overflow(oddSequenceStarts, backslash, &sequencesStartingOnEvenBits) ? 1 : 0;
+        uint64_t invertMask = sequencesStartingOnEvenBits << 1;
+
+        return (evenBits ^ invertMask) & followsEscape;
+    }
+
+    // Stage two
+    template<typename Handler>
+    static bool walkIndex(const char* json, const char* end, const std::vector<uint32_t>& indexes, Handler& handler,
+                          Reader::Context& ctx) {
+        enum State { EXPECT_VALUE, EXPECT_KEY, AFTER_VALUE };
+
+        Reader::LevelStack& stack = ctx.levels;
+        size_t i = 0;
+        const size_t n = indexes.size();
+        auto peek = [&]() { return i < n ? json[indexes[i]] : '\0'; };
+
+        // Parse the string, number or literal at the current index with the scalar routines of Reader,
+        // anything but whitespace between its end and the next index is an error
+        auto parseScalar = [&](bool isKey, ParseError trailing) {
+            StringReadStream is(std::string_view(json + indexes[i], static_cast<size_t>(end - json) - indexes[i]));
+            if (!(isKey ? Reader::parseString(is, handler, true, ctx) : Reader::parseScalar(is, handler, ctx))) {
+                ctx.offset += indexes[i];
+                return false;
+            }
+            const char* pos = is.getPos();
+            i++;
+            while (i < n && json + indexes[i] < pos) i++;
+            const char* next = i < n ? json + indexes[i] : end;
+            const char* trail = simd::skipWhitespace(pos, next);
+            if (trail != next) return Reader::fail(ctx, trailing, static_cast<size_t>(trail - json));
+            return true;
+        };
+        auto afterValueError = [&]() {
+            if (stack.empty()) return PARSE_ROOT_NOT_SINGULAR;
+            return stack.inObject() ? PARSE_MISS_COMMA_OR_CURLY_BRACKET : PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
+        };
+
+        State state = EXPECT_VALUE;
+        while (true) {
+            switch (state) {
+                case EXPECT_VALUE:
+                    if (i == n) FAIL(PARSE_EXPECT_VALUE);
+                    switch (peek()) {
+                        case '[':
+                            if (stack.depth() >= ctx.maxDepth) FAIL(PARSE_DEPTH_EXCEEDED);
+                            CALL(handler.StartArray());
+                            i++;
+                            if (peek() == ']') {
+                                i++;
+                                CALL(handler.EndArray());
+                                state = AFTER_VALUE;
+                            } else {
+                                stack.push(false);
+                            }
+                            break;
+                        case '{':
+                            if (stack.depth() >= ctx.maxDepth) FAIL(PARSE_DEPTH_EXCEEDED);
+                            CALL(handler.StartObject());
+                            i++;
+                            if (peek() == '}') {
+                                i++;
+                                CALL(handler.EndObject());
+                                state = AFTER_VALUE;
+                            } else {
+                                stack.push(true);
+                                state = EXPECT_KEY;
+                            }
+                            break;
+                        default:
+                            if (!parseScalar(false, afterValueError())) return false;
+                            state = AFTER_VALUE;
+                            break;
+                    }
+                    break;
+
+                case EXPECT_KEY:
+                    if (peek() != '"') FAIL(PARSE_MISS_KEY);
+                    if (!parseScalar(true, PARSE_MISS_COLON)) return false;
+                    if (peek() != ':') FAIL(PARSE_MISS_COLON);
+                    i++;
+                    state = EXPECT_VALUE;
+                    break;
+
+                case AFTER_VALUE:
+                    if (stack.empty()) {
+                        if (i != n) FAIL(PARSE_ROOT_NOT_SINGULAR);
+                        return true;
+                    }
+                    if (!stack.inObject()) {
+                        switch (peek()) {
+                            case ',':
+                                i++;
+                                state = EXPECT_VALUE;
+                                break;
+                            case ']':
+                                i++;
+                                stack.pop();
+                                CALL(handler.EndArray());
+                                break;
+                            default:
+                                FAIL(PARSE_MISS_COMMA_OR_SQUARE_BRACKET);
+                        }
+                    } else {
+                        switch (peek()) {
+                            case ',':
+                                i++;
+                                state = EXPECT_KEY;
+                                break;
+                            case '}':
+                                i++;
+                                stack.pop();
+                                CALL(handler.EndObject());
+                                break;
+                            default:
+                                FAIL(PARSE_MISS_COMMA_OR_CURLY_BRACKET);
+                        }
+                    }
+                    break;
+            }
+        }
+    }
+
+#undef CALL
+#undef FAIL
+};
+
+}  // namespace json
+
+#endif  // TINY_JSON_STRUCTURAL_READER_H
@@ -0,0 +1,432 @@
+#ifndef TINY_JSON_TAPE_DOCUMENT_H
+#define TINY_JSON_TAPE_DOCUMENT_H
+
+#include "Reader.h"
+#include "ReadStream.h"
+#include "Value.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json
+{
+
+class TapeDocument;
+
+// A read-only view of one value on the tape of a TapeDocument, cheap to copy and pass by value.
+// It stays valid as long as the document is alive and not parsed again.
+class TapeValue
+{
+    friend class TapeDocument;
+
+public:
+    class Iterator
+    {
+    public:
+        Iterator(const TapeDocument* _doc, size_t _index, bool _isObject)
+                : doc(_doc), index(_index), isObject(_isObject) {}
+
+        // The key of the current member, only for iterators over an object
+        [[nodiscard]] std::string_view key() const;
+
+        // The current element of an array, or the value of the current member of an object
+        [[nodiscard]] TapeValue value() const { return TapeValue(doc, isObject ? index + 1 : index); }
+
+        TapeValue operator*() const { return value(); }
+
+        Iterator& operator++() {
+            if (isObject) index++;
+            index = TapeValue(doc, index).after();
+            return *this;
+        }
+
+        bool operator==(const Iterator& rhs) const { return index == rhs.index; }
+
+    private:
+        const TapeDocument* doc;
+        size_t index;
+        bool isObject;
+    };
+
+public:
+    [[nodiscard]] ValueType getType() const;
+
+    [[nodiscard]] bool isNull() const { return getType() == TYPE_NULL; }
+
+    [[nodiscard]] bool getBool() const;
+
+    [[nodiscard]] int32_t getInt32() const;
+
+    [[nodiscard]] int64_t getInt64() const;
+
+    [[nodiscard]] double getDouble() const;
+
+    [[nodiscard]] std::string_view getString() const;
+
+    // Number of elements of an array or members of an object
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] Iterator begin() const { return Iterator(doc, index + 1, getType() == TYPE_OBJECT_PTR); }
+
+    [[nodiscard]] Iterator end() const { return Iterator(doc, after() - 1, getType() == TYPE_OBJECT_PTR); }
+
+    // Linear in the number of members, TapeDocument has no key index
+    [[nodiscard]] bool findMember(std::string_view key, TapeValue& value) const;
+
+    [[nodiscard]] TapeValue operator[](std::string_view key) const {
+        TapeValue v = *this;
+        [[maybe_unused]] bool found = findMember(key, v);
+        assert(found && "Key does not exist");
+        return v;
+    }
+
+    [[nodiscard]] TapeValue operator[](const char* key) const { return (*this)[std::string_view(key)]; }
+
+    // Linear in i, prefer iteration to walk a whole array
+    [[nodiscard]] TapeValue operator[](size_t i) const {
+        assert(getType() == TYPE_ARRAY_PTR && i < size());
+        auto it = begin();
+        while (i-- > 0) ++it;
+        return *it;
+    }
+
+    template<typename Handler>
+    bool writeTo(Handler& handler) const;
+
+private:
+    TapeValue(const TapeDocument* _doc, size_t _index) : doc(_doc), index(_index) {}
+
+    [[nodiscard]] uint64_t word() const;
+
+    // Index of the tape word following this value
+    [[nodiscard]] size_t after() const;
+
+private:
+    const TapeDocument* doc;
+    size_t index;
+};
+
+// An immutable document stored as one array of tagged 64-bit words plus one buffer for all strings,
+// an alternative to the tree of shared_ptr built by Document for read-mostly use.
+//
+// Every word keeps its tag in the high 8 bits and a payload in the low 56 bits:
+//   'n', 't', 'f'  null, true and false
+//   'i'            int32, the payload holds the value
+//   'l', 'd'       int64 and double, the value is the following word
+//   's'            string, the payload is its offset in the string buffer,
+//                  where a 32-bit length precedes the bytes
+//   '[', '{'       start of an array or object, the payload holds the element count in bits 32..55
+//                  and the index of the word following the matching end in bits 0..31
+//   ']', '}'       end of an array or object, the payload is the index of the matching start
+// Object members are stored as a key string followed by the value.
+// Lengths and tape indexes are 32 bits wide: a string of 4 GiB or more, or a tape of more than MAX_TAPE_SIZE
+// words, fails the parse with PARSE_DOCUMENT_TOO_LARGE.
+class TapeDocument : noncopyable
+{
+    friend class TapeValue;
+
+public:
+    TapeDocument() = default;
+
+    ParseResult parse(const char* json, size_t len) { return parse(std::string_view(json, len)); }
+
+    ParseResult parse(std::string_view json) {
+        StringReadStream is(json);
+        return parseStream(is);
+    }
+
+    template<typename ReadStream>
+    ParseResult parseStream(ReadStream& is, size_t maxDepth = Reader::DEFAULT_MAX_DEPTH) {
+        tape.clear();
+        strings.clear();
+        st.clear();
+        tooLarge = false;
+        ParseResult result = Reader::parse(is, *this, maxDepth);
+        if (tooLarge) return ParseResult(PARSE_DOCUMENT_TOO_LARGE, result.getOffset());
+        return result;
+    }
+
+    [[nodiscard]] TapeValue root() const {
+        assert(!tape.empty());
+        return TapeValue(this, 0);
+    }
+
+    [[nodiscard]] ValueType getType() const { return root().getType(); }
+
+    [[nodiscard]] TapeValue operator[](std::string_view key) const { return root()[key]; }
+
+    [[nodiscard]] TapeValue operator[](const char* key) const { return root()[key]; }
+
+    [[nodiscard]] TapeValue operator[](size_t i) const { return root()[i]; }
+
+    template<typename Handler>
+    bool writeTo(Handler& handler) const { return root().writeTo(handler); }
+
+public:
+    bool Null() {
+        addValue();
+        append('n', 0);
+        return true;
+    }
+
+    bool Bool(bool b) {
+        addValue();
+        append(b ? 't' : 'f', 0);
+        return true;
+    }
+
+    bool Int32(int32_t i32) {
+        addValue();
+        append('i', static_cast<uint32_t>(i32));
+        return true;
+    }
+
+    bool Int64(int64_t i64) {
+        addValue();
+        append('l', 0);
+        tape.push_back(static_cast<uint64_t>(i64));
+        return true;
+    }
+
+    bool Double(double d) {
+        addValue();
+        append('d', 0);
+        tape.push_back(std::bit_cast<uint64_t>(d));
+        return true;
+    }
+
+    bool String(std::string_view s) {
+        addValue();
+        return appendString(s);
+    }
+
+    bool StartObject() {
+        addValue();
+        st.push_back({tape.size(), 0});
+        append('{', 0);
+        return true;
+    }
+
+    bool Key(std::string_view s) {
+        assert(!st.empty() && tagOf(tape[st.back().start]) == '{');
+        return appendString(s);
+    }
+
+    bool EndObject() { return endContainer('}'); }
+
+    bool StartArray() {
+        addValue();
+        st.push_back({tape.size(), 0});
+        append('[', 0);
+        return true;
+    }
+
+    bool EndArray() { return endContainer(']'); }
+
+private:
+    static constexpr uint64_t PAYLOAD_MASK = (uint64_t{1} << 56) - 1;
+    static constexpr uint64_t MAX_COUNT = (uint64_t{1} << 24) - 1;
+    static constexpr size_t MAX_TAPE_SIZE = std::numeric_limits<uint32_t>::max();
+
+    static char tagOf(uint64_t word) { return static_cast<char>(word >> 56); }
+
+    static uint64_t payloadOf(uint64_t word) { return word & PAYLOAD_MASK; }
+
+    void append(char tag, uint64_t payload) {
+        assert(payload <= PAYLOAD_MASK);
+        tape.push_back(static_cast<uint64_t>(static_cast<unsigned char>(tag)) << 56 | payload);
+    }
+
+    bool appendString(std::string_view s) {
+        if (s.size() > std::numeric_limits<uint32_t>::max()) return fail();
+        append('s', strings.size());
+        auto len = static_cast<uint32_t>(s.size());
+        strings.append(reinterpret_cast<const char*>(&len), sizeof(len));
+        strings.append(s);
+        return true;
+    }
+
+    // Stop the parse, which reports PARSE_DOCUMENT_TOO_LARGE
+    bool fail() {
+        tooLarge = true;
+        return false;
+    }
+
+    // Count one more element in the innermost container
+    void addValue() {
+        if (!st.empty()) st.back().count++;
+    }
+
+    bool endContainer(char tag) {
+        assert(!st.empty());
+        Level level = st.back();
+        st.pop_back();
+        append(tag, level.start);
+        if (tape.size() > MAX_TAPE_SIZE) return fail();
+        uint64_t count = std::min<uint64_t>(level.count, MAX_COUNT);
+        tape[level.start] |= count << 32 | tape.size();
+        return true;
+    }
+
+private:
+    struct Level
+    {
+        size_t start;  // index of the start word
+        size_t count;  // number of elements, or of members for an object
+    };
+
+private:
+    std::vector<uint64_t> tape;
+    std::string strings;
+    std::vector<Level> st;
+    bool tooLarge = false;  // a string or the tape outgrew the 32 bits kept for it
+};
+
+inline uint64_t TapeValue::word() const { return doc->tape[index]; }
+
+inline size_t TapeValue::after() const {
+    switch (TapeDocument::tagOf(word())) {
+        case 'l':
+        case 'd':
+            return index + 2;
+        case '[':
+        case '{':
+            return static_cast<uint32_t>(TapeDocument::payloadOf(word()));
+        default:
+            return index + 1;
+    }
+}
+
+inline ValueType TapeValue::getType() const {
+    switch (TapeDocument::tagOf(word())) {
+        case 'n':
+            return TYPE_NULL;
+        case 't':
+        case 'f':
+            return TYPE_BOOL;
+        case 'i':
+            return TYPE_INT32;
+        case 'l':
+            return TYPE_INT64;
+        case 'd':
+            return TYPE_DOUBLE;
+        case 's':
+            return TYPE_STRING_PTR;
+        case '[':
+            return TYPE_ARRAY_PTR;
+        case '{':
+            return TYPE_OBJECT_PTR;
+        default:
+            assert(false && "bad tape word");
+            return TYPE_NULL;
+    }
+}
+
+inline bool TapeValue::getBool() const {
+    assert(getType() == TYPE_BOOL);
+    return TapeDocument::tagOf(word()) == 't';
+}
+
+inline int32_t TapeValue::getInt32() const {
+    assert(getType() == TYPE_INT32);
+    return static_cast<int32_t>(static_cast<uint32_t>(word()));
+}
+
+inline int64_t TapeValue::getInt64() const {
+    assert(getType() == TYPE_INT64);
+    return static_cast<int64_t>(doc->tape[index + 1]);
+}
+
+inline double TapeValue::getDouble() const {
+    assert(getType() == TYPE_DOUBLE);
+    return std::bit_cast<double>(doc->tape[index + 1]);
+}
+
+inline std::string_view TapeValue::getString() const {
+    assert(getType() == TYPE_STRING_PTR);
+    const char* p = doc->strings.data() + TapeDocument::payloadOf(word());
+    uint32_t len;
+    memcpy(&len, p, sizeof(len));
+    return {p + sizeof(len), len};
+}
+
+inline size_t TapeValue::size() const {
+    assert(getType() == TYPE_ARRAY_PTR || getType() == TYPE_OBJECT_PTR);
+    auto count = static_cast<size_t>(TapeDocument::payloadOf(word()) >> 32);
+    if (count < TapeDocument::MAX_COUNT) return count;
+    // the count saturated, walk the elements
+    count = 0;
+    for (auto it = begin(); it != end(); ++it) count++;
+    return count;
+}
+
+inline bool TapeValue::findMember(std::string_view key, TapeValue& value) const {
+    assert(getType() == TYPE_OBJECT_PTR);
+    for (auto it = begin(); it != end(); ++it) {
+        if (it.key() == key) {
+            value = it.value();
+            return true;
+        }
+    }
+    return false;
+}
+
+inline std::string_view TapeValue::Iterator::key() const {
+    assert(isObject);
+    return TapeValue(doc, index).getString();
+}
+
+#define CALL(expr) do { if (!(expr)) return false; } while(false)
+
+template<typename Handler>
+inline bool TapeValue::writeTo(Handler& handler) const {
+    switch (getType()) {
+        case TYPE_NULL:
+            CALL(handler.Null());
+            break;
+        case TYPE_BOOL:
+            CALL(handler.Bool(getBool()));
+            break;
+        case TYPE_INT32:
+            CALL(handler.Int32(getInt32()));
+            break;
+        case TYPE_INT64:
+            CALL(handler.Int64(getInt64()));
+            break;
+        case TYPE_DOUBLE:
+            CALL(handler.Double(getDouble()));
+            break;
+        case TYPE_STRING_PTR:
+            CALL(handler.String(getString()));
+            break;
+        case TYPE_ARRAY_PTR:
+            CALL(handler.StartArray());
+            for (auto it = begin(); it != end(); ++it) {
+                CALL(it.value().writeTo(handler));
+            }
+            CALL(handler.EndArray());
+            break;
+        case TYPE_OBJECT_PTR:
+            CALL(handler.StartObject());
+            for (auto it = begin(); it != end(); ++it) {
+                CALL(handler.Key(it.key()));
+                CALL(it.value().writeTo(handler));
+            }
+            CALL(handler.EndObject());
+            break;
+    }
+    return true;
+}
+
+#undef CALL
+
+}  // namespace json
+
+#endif  // TINY_JSON_TAPE_DOCUMENT_H
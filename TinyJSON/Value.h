@@ -5,12 +5,19 @@
 
 #include <cassert>
 #include <cstring>
+#include <ostream>
 #include <string>
 #include <string_view>
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <algorithm>
 #include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
 #include <variant>
 
 namespace json
@@ -18,17 +25,223 @@ namespace json
 
 
 class Value;
+class Object;
+
+// The containers take a std::pmr allocator so that a Document can place them in its arena,
+// by default they use the global heap like their std counterparts
+typedef std::pmr::string String;
+typedef std::pmr::vector<Value> Array;
+// The key is a string Value, so that short keys are stored inline too
+typedef std::pair<Value, Value> Pair;
+
+// A reference counted pointer like std::shared_ptr, but one pointer wide: the count lives in the node,
+// next to the string, array or object, which is allocated from the same memory resource as its contents
+template<typename T>
+class NodePtr
+{
+    friend class Value;
+
+public:
+    NodePtr() = default;
+
+    NodePtr(std::nullptr_t) {}
+
+    NodePtr(const NodePtr& rhs) : node(rhs.node) { retain(node); }
+
+    NodePtr(NodePtr&& rhs) noexcept : node(std::exchange(rhs.node, nullptr)) {}
+
+    NodePtr& operator=(NodePtr rhs) noexcept {
+        std::swap(node, rhs.node);
+        return *this;
+    }
+
+    ~NodePtr() { release(node); }
+
+    // A new T constructed from args with an allocator of "resource", the node comes from there as well
+    template<typename... Args>
+    static NodePtr make(std::pmr::memory_resource* resource, Args&& ... args) {
+        std::pmr::polymorphic_allocator<Node> alloc(resource);
+        Node* n = alloc.allocate(1);
+        try {
+            std::construct_at(n, resource, std::forward<Args>(args)...);
+        } catch (...) {
+            alloc.deallocate(n, 1);
+            throw;
+        }
+        return NodePtr(n);
+    }
+
+    T& operator*() const { return node->value; }
+
+    T* operator->() const { return &node->value; }
+
+    [[nodiscard]] T* get() const { return node ? &node->value : nullptr; }
+
+    explicit operator bool() const { return node != nullptr; }
+
+    bool operator==(const NodePtr& rhs) const { return node == rhs.node; }
+
+    bool operator==(std::nullptr_t) const { return node == nullptr; }
+
+    [[nodiscard]] uint32_t useCount() const { return node ? node->refs.load(std::memory_order_relaxed) : 0; }
+
+private:
+    struct Node
+    {
+        template<typename... Args>
+        explicit Node(std::pmr::memory_resource* resource, Args&& ... args)
+                : value(std::make_obj_using_allocator<T>(std::pmr::polymorphic_allocator<T>(resource),
+                                                         std::forward<Args>(args)...)) {}
+
+        std::atomic<uint32_t> refs = 1;
+        T value;
+    };
+
+    // Takes over the reference held by n
+    explicit NodePtr(Node* n) : node(n) {}
+
+    // Hands the reference over to the caller
+    Node* detach() { return std::exchange(node, nullptr); }
+
+    static void retain(Node* n) {
+        if (n) n->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void release(Node* n) {
+        // the only owner skips the atomic read-modify-write, nobody else can take a reference meanwhile
+        if (n && (n->refs.load(std::memory_order_acquire) == 1 ||
+                  n->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)) {
+            std::pmr::polymorphic_allocator<Node> alloc(n->value.get_allocator().resource());
+            std::destroy_at(n);
+            alloc.deallocate(n, 1);
+        }
+    }
+
+private:
+    Node* node = nullptr;
+};
+
+typedef NodePtr<String> StringPtr;
+typedef NodePtr<Array> ArrayPtr;
+typedef NodePtr<Object> ObjectPtr;
+
+// FNV-1a, usable at compile time for KeyToken
+constexpr uint64_t hashKey(std::string_view key) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c: key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// A key known at compile time, hashed by the compiler: doc[KeyToken("Zip")]
+class KeyToken
+{
+public:
+    template<size_t N>
+    consteval explicit KeyToken(const char (&s)[N]) : str(s, N - 1), hash(hashKey(str)) {}
+
+    [[nodiscard]] constexpr std::string_view get() const { return str; }
+
+    [[nodiscard]] constexpr uint64_t getHash() const { return hash; }
+
+private:
+    std::string_view str;
+    uint64_t hash;
+};
+
+// The members of an object in order. Objects of at least INDEX_THRESHOLD members also get a hash index
+// over their keys, built by Document when it finishes parsing the object or by reindex().
+// Lookups only read the index, so a parsed document can be searched from several threads.
+// Members appended after the index was built are searched linearly until the next reindex().
+// Only reading and appending are exposed, the members that remove drop the index. Changing a key
+// or moving members through the element references needs a reindex() as well.
+class Object : private std::pmr::vector<Pair>
+{
+    typedef std::pmr::vector<Pair> Members;
+
+public:
+    using typename Members::value_type;
+    using typename Members::allocator_type;
+    using typename Members::size_type;
+    using typename Members::iterator;
+    using typename Members::const_iterator;
 
-typedef std::string String;
-typedef std::shared_ptr<String> StringPtr;
-typedef std::vector<Value> Array;
-typedef std::shared_ptr<Array> ArrayPtr;
-typedef std::pair<StringPtr, Value> Pair;
-typedef std::vector<Pair> Object;
-typedef std::shared_ptr<Object> ObjectPtr;
+    using Members::get_allocator;
+    using Members::begin;
+    using Members::end;
+    using Members::cbegin;
+    using Members::cend;
+    using Members::size;
+    using Members::empty;
+    using Members::data;
+    using Members::operator[];
+    using Members::front;
+    using Members::back;
+    using Members::capacity;
+    using Members::reserve;
+    using Members::push_back;
+    using Members::emplace_back;
 
+    static constexpr size_t INDEX_THRESHOLD = 16;
 
-//Must be consistent with the order defined by the member variable "data" type
+    Object() = default;
+
+    explicit Object(const allocator_type& alloc) : Members(alloc), index(alloc) {}
+
+    Object(const Object& rhs) = default;
+
+    Object(Object&& rhs) noexcept = default;
+
+    Object(const Object& rhs, const allocator_type& alloc)
+            : Members(rhs, alloc), index(rhs.index, alloc), indexed(rhs.indexed) {}
+
+    Object& operator=(const Object& rhs) = default;
+
+    Object& operator=(Object&& rhs) noexcept = default;
+
+    void resize(size_type n) {
+        dropIndex();
+        Members::resize(n);
+    }
+
+    void pop_back() {
+        dropIndex();
+        Members::pop_back();
+    }
+
+    void clear() {
+        dropIndex();
+        Members::clear();
+    }
+
+    // The first member named key, nullptr if there is none. Only keys looked up in the index are hashed.
+    [[nodiscard]] const Pair* find(std::string_view key) const { return find(key, indexed > 0 ? hashKey(key) : 0); }
+
+    // The same with the hash of key precomputed, see KeyToken
+    [[nodiscard]] const Pair* find(std::string_view key, uint64_t hash) const;
+
+    // Index the current members, or drop the index if there are too few of them
+    void reindex();
+
+private:
+    struct Slot
+    {
+        uint32_t hash = 0;    // low bits of the hash of the key
+        uint32_t member = 0;  // 1 + the position of the member, 0 for an empty slot
+    };
+
+    void dropIndex() {
+        index.clear();
+        indexed = 0;
+    }
+
+    std::pmr::vector<Slot> index;
+    size_t indexed = 0;  // the number of members covered by the index
+};
+
+// Kept in the tag byte of Value
 enum ValueType : size_t
 {
     TYPE_NULL = 0,
@@ -41,6 +254,17 @@ enum ValueType : size_t
     TYPE_OBJECT_PTR,
 };
 
+// How a Value holds its string, array or object node, kept in the tag byte next to the type
+enum Ownership : uint8_t
+{
+    OWN_SHARED,    // reference counted, a copy shares the node
+    OWN_UNIQUE,    // one owner, a copy is a deep copy on the heap, so no count is ever contended
+    OWN_BORROWED,  // neither counted nor freed, the node lives in an arena which outlives every copy
+};
+
+// 16 bytes: a scalar or a node pointer in the first 8, or a string of up to SHORT_STRING_LENGTH bytes
+// stored inline with its length in byte 14, and the type and ownership in byte 15.
+// Longer strings, arrays and objects are nodes, what a copy of the Value does with them depends on the Ownership.
 class Value
 {
     friend class Document;
@@ -48,197 +272,473 @@ class Value
     friend std::ostream& operator<<(std::ostream& os, const Value& v);
 
 public:
-    Value() : data(std::monostate()) {}
+    // The longest string stored inline
+    static constexpr size_t SHORT_STRING_LENGTH = 14;
+
+    Value() = default;
 
     template<typename T>
     requires std::convertible_to<T, std::variant<bool, int32_t, int64_t, double>>
-    explicit Value(T newData) : data(newData) {}
+    explicit Value(T newData) { setScalar(newData); }
 
-    explicit Value(std::string_view s) : data(std::make_shared<String>(s.begin(), s.end())) {}
+    explicit Value(std::string_view s) { setString(s, std::pmr::get_default_resource()); }
 
-    explicit Value(const char* s) : data(std::make_shared<String>(s, s + strlen(s))) {}
+    // A string longer than SHORT_STRING_LENGTH is allocated from "resource", which must outlive it
+    Value(std::string_view s, std::pmr::memory_resource* resource) { setString(s, resource); }
+
+    explicit Value(const char* s) : Value(std::string_view(s)) {}
 
     Value(const char* s, size_t len) : Value(std::string_view(s, len)) {}
 
-    Value(const Value& rhs) : data(rhs.data) {}
+    // Take over the node of the pointer. A borrowed node is never released, it must come from an arena.
+    explicit Value(StringPtr str, Ownership ownership = OWN_SHARED) {
+        adopt(TYPE_STRING_PTR, ownership, str.detach());
+    }
+
+    explicit Value(ArrayPtr array, Ownership ownership = OWN_SHARED) {
+        adopt(TYPE_ARRAY_PTR, ownership, array.detach());
+    }
+
+    explicit Value(ObjectPtr object, Ownership ownership = OWN_SHARED) {
+        adopt(TYPE_OBJECT_PTR, ownership, object.detach());
+    }
 
-    Value(Value&& rhs) : data(rhs.data) { rhs.data = std::monostate(); }
+    Value(const Value& rhs) {
+        memcpy(raw, rhs.raw, sizeof(raw));
+        copyNode();
+    }
+
+    Value(Value&& rhs) noexcept {
+        memcpy(raw, rhs.raw, sizeof(raw));
+        rhs.clear();
+    }
 
-    Value& operator=(Value&& rhs) {
+    Value& operator=(Value&& rhs) noexcept {
         if (this == &rhs) return *this;
-        data = rhs.data;
-        rhs.data = std::monostate();
+        release();
+        memcpy(raw, rhs.raw, sizeof(raw));
+        rhs.clear();
         return *this;
     }
 
-    Value& operator=(const Value& rhs) = default;
+    Value& operator=(const Value& rhs) {
+        if (this == &rhs) return *this;
+        Value copy(rhs);
+        return *this = std::move(copy);
+    }
 
-    ~Value() = default;
+    ~Value() { release(); }
 
     template<typename T>
     requires std::convertible_to<T, std::variant<bool, int32_t, int64_t, double>>
     Value& operator=(const T rhs) {
-        data = rhs;
+        release();
+        setScalar(rhs);
         return *this;
     }
 
-    static Value emptyString() {
-        Value v;
-        v.data = std::make_shared<String>();
-        return v;
-    }
+    static Value emptyString() { return Value(std::string_view()); }
 
-    static Value emptyArray() {
-        Value v;
-        v.data = std::make_shared<Array>();
-        return v;
+    // The array or object, and the elements added to it later, are allocated from "resource"
+    static Value emptyArray(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        return Value(ArrayPtr::make(resource));
     }
 
-    static Value emptyObject() {
-        Value v;
-        v.data = std::make_shared<Object>();
-        return v;
+    static Value emptyObject(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        return Value(ObjectPtr::make(resource));
     }
 
-    [[nodiscard]] ValueType getType() const { return static_cast<ValueType>(data.index()); }
+    [[nodiscard]] ValueType getType() const { return static_cast<ValueType>(tag() & TYPE_MASK); }
+
+    // Whether this is a string stored inline rather than in a node
+    [[nodiscard]] bool isShortString() const { return tag() == (TYPE_STRING_PTR | SHORT_FLAG); }
+
+    // How the node is held, OWN_SHARED for scalars and short strings, which have none
+    [[nodiscard]] Ownership getOwnership() const { return static_cast<Ownership>((tag() & OWNERSHIP_MASK) >> 4); }
 
     template<typename T>
     requires std::convertible_to<T, std::variant<bool, int32_t, int64_t, double, StringPtr, ArrayPtr, ObjectPtr>>
     // Get the value saved by the class member variable "data",
-    // which can be bool, int32_t, int64_t, double, or a smart pointer of type StringPtr, ArrayPtr, ObjectPtr
+    // which can be bool, int32_t, int64_t, double, or a smart pointer of type StringPtr, ArrayPtr, ObjectPtr.
+    // A short string has no node to share, its StringPtr is a copy on the default resource which the value
+    // does not see changes to. getString() reads any string without allocating.
     [[nodiscard]] T getData() const {
-        return std::get<T>(data);
+        if constexpr (std::is_same_v<T, bool>) {
+            assert(getType() == TYPE_BOOL);
+        } else if constexpr (std::is_same_v<T, int32_t>) {
+            assert(getType() == TYPE_INT32);
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            assert(getType() == TYPE_INT64);
+        } else if constexpr (std::is_same_v<T, double>) {
+            assert(getType() == TYPE_DOUBLE);
+        } else {
+            assert(getType() == (std::is_same_v<T, StringPtr> ? TYPE_STRING_PTR :
+                                 std::is_same_v<T, ArrayPtr> ? TYPE_ARRAY_PTR : TYPE_OBJECT_PTR));
+            if constexpr (std::is_same_v<T, StringPtr>) {
+                if (isShortString()) return StringPtr::make(std::pmr::get_default_resource(), getString());
+            }
+            auto n = load<typename T::Node*>();
+            T::retain(n);
+            return T(n);
+        }
+        if constexpr (std::is_arithmetic_v<T>) return load<T>();
+    }
+
+    // Any string, inline or in a node. Prefer it to getData<StringPtr>(), which copies a short string.
+    [[nodiscard]] std::string_view getString() const {
+        assert(getType() == TYPE_STRING_PTR);
+        if (isShortString()) return {raw, static_cast<size_t>(raw[LENGTH_BYTE])};
+        return load<StringPtr::Node*>()->value;
+    }
+
+    // The array, object or element count by reference, reading them does not touch the reference count
+    [[nodiscard]] Array& getArray() { return array(); }
+
+    [[nodiscard]] const Array& getArray() const { return array(); }
+
+    [[nodiscard]] Object& getObject() { return object(); }
+
+    [[nodiscard]] const Object& getObject() const { return object(); }
+
+    [[nodiscard]] size_t size() const {
+        return getType() == TYPE_ARRAY_PTR ? array().size() : object().size();
     }
 
+    // Views over the elements of an array and the members of an object, for range-for
+    [[nodiscard]] std::span<Value> elements() { return array(); }
+
+    [[nodiscard]] std::span<const Value> elements() const { return array(); }
+
+    [[nodiscard]] std::span<Pair> members() { return object(); }
+
+    [[nodiscard]] std::span<const Pair> members() const { return object(); }
+
     template<typename T>
     requires std::convertible_to<T, std::variant<bool, int32_t, int64_t, double>>
     [[nodiscard]] Value& setData(T newData) {
-        data = newData;
+        release();
+        setScalar(newData);
         return *this;
     }
 
     template<typename T>
     requires std::convertible_to<T, std::variant<String, Array, Object>>
     [[nodiscard]] Value& setData(T& newData) {
-        data = std::make_shared<T>(newData);
+        if constexpr (std::is_same_v<T, String>) {
+            *this = Value(std::string_view(newData));
+        } else {
+            *this = Value(NodePtr<T>::make(std::pmr::get_default_resource(), newData));
+        }
         return *this;
     }
 
-    [[nodiscard]] Value& operator[](const std::string& key) {
-        Pair* p = findPair(key);
-        assert(p && "Key does not exist");
-        return p->second;
-    }
+    [[nodiscard]] Value& operator[](std::string_view key) { return member(findPair(key)); }
 
-    [[nodiscard]] const Value& operator[](const std::string& key) const { return const_cast<Value&>(*this)[key]; }
+    [[nodiscard]] const Value& operator[](std::string_view key) const { return const_cast<Value&>(*this)[key]; }
 
-    [[nodiscard]] Pair* findPair(const std::string& key) {
-        for (Pair& p: *std::get<ObjectPtr>(data)) {
-            if (*p.first == key) return &p;
-        }
-        return nullptr;
+    [[nodiscard]] Value& operator[](const KeyToken& key) { return member(findPair(key)); }
+
+    [[nodiscard]] const Value& operator[](const KeyToken& key) const { return const_cast<Value&>(*this)[key]; }
+
+    // The first member named key, nullptr if there is none
+    [[nodiscard]] Pair* findPair(std::string_view key) { return const_cast<Pair*>(object().find(key)); }
+
+    [[nodiscard]] const Pair* findPair(std::string_view key) const { return const_cast<Value&>(*this).findPair(key); }
+
+    [[nodiscard]] Pair* findPair(const KeyToken& key) {
+        return const_cast<Pair*>(object().find(key.get(), key.getHash()));
     }
 
-    [[nodiscard]] const Pair* findPair(const std::string& key) const { return const_cast<Value&>(*this).findPair(key); }
+    [[nodiscard]] const Pair* findPair(const KeyToken& key) const { return const_cast<Value&>(*this).findPair(key); }
 
+    // Strings are allocated from the memory resource of the object
     template<typename T>
     requires std::convertible_to<T, std::variant<bool, int32_t, int64_t, double, String>>
     void addPair(const String&& key, T&& value) {
-        assert(data.index() == TYPE_OBJECT_PTR && "Non-object types cannot add key-value pairs");
-        std::get<ObjectPtr>(data)->emplace_back(std::make_shared<String>(key), value);
+        assert(getType() == TYPE_OBJECT_PTR && "Non-object types cannot add key-value pairs");
+        std::pmr::memory_resource* resource = object().get_allocator().resource();
+        if constexpr (std::is_convertible_v<T, std::string_view>) {
+            object().emplace_back(Value(std::string_view(key), resource), Value(std::string_view(value), resource));
+        } else {
+            object().emplace_back(Value(std::string_view(key), resource), Value(std::forward<T>(value)));
+        }
     };
 
-    void addPair(const Value&& key, const Value&& value) {
-        assert(data.index() == TYPE_OBJECT_PTR && "Non-object types cannot add key-value pairs");
-        std::get<ObjectPtr>(data)->emplace_back(key.getData<StringPtr>(), value);
+    void addPair(Value&& key, Value&& value) {
+        assert(getType() == TYPE_OBJECT_PTR && "Non-object types cannot add key-value pairs");
+        assert(key.getType() == TYPE_STRING_PTR && "keys are strings");
+        object().emplace_back(std::move(key), std::move(value));
     };
 
     // When the type is Array, it is used to add Value
     template<typename T>
     requires std::convertible_to<T, std::variant<bool, int32_t, int64_t, double>>
     void addToArray(T value) {
-        std::get<ArrayPtr>(data)->emplace_back(value);
+        array().emplace_back(value);
     }
 
-    // When the type is Array, it is used to add Value
+    // When the type is Array, it is used to add Value, allocated from the memory resource of the array
     void addToArray(const String& value) {
-        std::get<ArrayPtr>(data)->emplace_back(value);
+        array().emplace_back(std::string_view(value), array().get_allocator().resource());
     }
 
     // When the type is Array, it is used to add Value
     void addToArray(Value&& value) {
-        std::get<ArrayPtr>(data)->emplace_back(std::forward<Value>(value));
+        array().emplace_back(std::move(value));
     }
 
     const Value& operator[](size_t i) const {
-        return (*std::get<ArrayPtr>(data))[i];
+        return const_cast<Value&>(*this).array()[i];
     }
 
     Value& operator[](size_t i) {
-        return (*std::get<ArrayPtr>(data))[i];
+        return array()[i];
     }
 
     template<typename Handler>
     bool writeTo(Handler& handler) const;
 
 private:
-    std::variant<std::monostate, bool, int32_t, int64_t, double, StringPtr, ArrayPtr, ObjectPtr> data;
+    static constexpr uint8_t TYPE_MASK = 0x0F;
+    static constexpr uint8_t OWNERSHIP_MASK = 0x30;
+    static constexpr uint8_t SHORT_FLAG = 0x80;  // set in the tag of a short string
+    static constexpr size_t LENGTH_BYTE = 14;
+    static constexpr size_t TAG_BYTE = 15;
+
+    static Value& member(Pair* p) {
+        assert(p && "Key does not exist");
+        return p->second;
+    }
+
+    [[nodiscard]] uint8_t tag() const { return static_cast<uint8_t>(raw[TAG_BYTE]); }
+
+    template<typename T>
+    [[nodiscard]] T load() const {
+        T t;
+        memcpy(&t, raw, sizeof(T));
+        return t;
+    }
+
+    template<typename T>
+    void store(T t, uint8_t newTag) {
+        memset(raw, 0, sizeof(raw));
+        memcpy(raw, &t, sizeof(T));
+        raw[TAG_BYTE] = static_cast<char>(newTag);
+    }
+
+    template<typename T>
+    void setScalar(T newData) {
+        std::visit([&](auto scalar) {
+            using S = decltype(scalar);
+            ValueType type = std::is_same_v<S, bool> ? TYPE_BOOL : std::is_same_v<S, int32_t> ? TYPE_INT32 :
+                                                                   std::is_same_v<S, int64_t> ? TYPE_INT64 : TYPE_DOUBLE;
+            store(scalar, static_cast<uint8_t>(type));
+        }, std::variant<bool, int32_t, int64_t, double>(newData));
+    }
+
+    void setString(std::string_view s, std::pmr::memory_resource* resource) {
+        if (s.size() <= SHORT_STRING_LENGTH) {
+            memset(raw, 0, sizeof(raw));
+            memcpy(raw, s.data(), s.size());
+            raw[LENGTH_BYTE] = static_cast<char>(s.size());
+            raw[TAG_BYTE] = static_cast<char>(TYPE_STRING_PTR | SHORT_FLAG);
+        } else {
+            adopt(TYPE_STRING_PTR, OWN_SHARED, StringPtr::make(resource, s).detach());
+        }
+    }
+
+    // Take over the reference to a node of the given type, which must not be released by its NodePtr
+    void adopt(ValueType type, Ownership ownership, void* node) {
+        if (node == nullptr) {
+            clear();
+        } else {
+            store(node, static_cast<uint8_t>(type | ownership << 4));
+        }
+    }
+
+    // Point at the string of p without taking a reference, it must outlive this value and its copies
+    static Value borrow(const StringPtr& p) {
+        Value v;
+        v.adopt(TYPE_STRING_PTR, OWN_BORROWED, p.node);
+        return v;
+    }
+
+    [[nodiscard]] Array& array() const {
+        assert(getType() == TYPE_ARRAY_PTR);
+        return load<ArrayPtr::Node*>()->value;
+    }
+
+    [[nodiscard]] Object& object() const {
+        assert(getType() == TYPE_OBJECT_PTR);
+        return load<ObjectPtr::Node*>()->value;
+    }
+
+    void clear() {
+        memset(raw, 0, sizeof(raw));
+    }
+
+    // Called on a fresh bitwise copy of a value: share, copy or keep borrowing its node
+    void copyNode() {
+        if (isShortString()) return;
+        switch (getType()) {
+            case TYPE_STRING_PTR:
+                copyNode<String>();
+                break;
+            case TYPE_ARRAY_PTR:
+                copyNode<Array>();
+                break;
+            case TYPE_OBJECT_PTR:
+                copyNode<Object>();
+                break;
+            default:
+                break;
+        }
+    }
+
+    template<typename T>
+    void copyNode() {
+        auto n = load<typename NodePtr<T>::Node*>();
+        if (getOwnership() == OWN_SHARED) {
+            NodePtr<T>::retain(n);
+        } else if (getOwnership() == OWN_UNIQUE) {
+            // the elements are copied by their own ownership
+            auto copy = NodePtr<T>::make(std::pmr::get_default_resource(), n->value).detach();
+            memcpy(raw, &copy, sizeof(copy));
+        }
+    }
+
+    void release() {
+        if (!isShortString() && getOwnership() != OWN_BORROWED) {
+            switch (getType()) {
+                case TYPE_STRING_PTR:
+                    StringPtr::release(load<StringPtr::Node*>());
+                    break;
+                case TYPE_ARRAY_PTR:
+                    ArrayPtr::release(load<ArrayPtr::Node*>());
+                    break;
+                case TYPE_OBJECT_PTR:
+                    ObjectPtr::release(load<ObjectPtr::Node*>());
+                    break;
+                default:
+                    break;
+            }
+        }
+        clear();
+    }
+
+    alignas(8) char raw[16] = {};
 };
 
+static_assert(sizeof(Value) == 16, "Value must stay 16 bytes");
+// so that growing an Array moves its elements instead of copying them
+static_assert(std::is_nothrow_move_constructible_v<Value> && std::is_nothrow_move_constructible_v<Pair>);
+
+inline const Pair* Object::find(std::string_view key, uint64_t hash) const {
+    size_t n = size();
+    size_t linearFrom = 0;
+    if (indexed > 0 && indexed <= n) {
+        const size_t mask = index.size() - 1;
+        for (size_t slot = hash & mask; index[slot].member != 0; slot = (slot + 1) & mask) {
+            const Pair& p = (*this)[index[slot].member - 1];
+            if (index[slot].hash == static_cast<uint32_t>(hash) && p.first.getString() == key) return &p;
+        }
+        linearFrom = indexed;
+    }
+    for (size_t i = linearFrom; i < n; i++) {
+        if ((*this)[i].first.getString() == key) return &(*this)[i];
+    }
+    return nullptr;
+}
+
+inline void Object::reindex() {
+    dropIndex();
+    if (size() < INDEX_THRESHOLD || size() >= std::numeric_limits<uint32_t>::max()) return;
+
+    // at most half full, the probe sequences stay short
+    index.resize(std::bit_ceil(size() * 2));
+    const size_t mask = index.size() - 1;
+    for (size_t i = 0; i < size(); i++) {
+        std::string_view key = (*this)[i].first.getString();
+        uint64_t hash = hashKey(key);
+        size_t slot = hash & mask;
+        bool duplicate = false;
+        for (; index[slot].member != 0; slot = (slot + 1) & mask) {
+            // keep the first of duplicate keys, as a linear search would find
+            if (index[slot].hash == static_cast<uint32_t>(hash) &&
+                (*this)[index[slot].member - 1].first.getString() == key) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (!duplicate) index[slot] = {static_cast<uint32_t>(hash), static_cast<uint32_t>(i + 1)};
+    }
+    indexed = size();
+}
+
 #define CALL(expr) do { if (!(expr)) return false; } while(false)
 
 template<typename Handler>
 inline bool Value::writeTo(Handler& handler) const {
-    bool res = std::visit([&](auto& arg) {
-        using T = std::decay_t<decltype(arg)>;
-        if constexpr (std::is_same_v<T, std::monostate>) {
+    switch (getType()) {
+        case TYPE_NULL:
             CALL(handler.Null());
-        } else if constexpr (std::is_same_v<T, bool>) {
-            CALL(handler.Bool(getData<bool>()));
-        } else if constexpr (std::is_same_v<T, int32_t>) {
-            CALL(handler.Int32(getData<int32_t>()));
-        } else if constexpr (std::is_same_v<T, int64_t>) {
-            CALL(handler.Int64(getData<int64_t>()));
-        } else if constexpr (std::is_same_v<T, double>) {
-            CALL(handler.Double(getData<double>()));
-        } else if constexpr (std::is_same_v<T, StringPtr>) {
-            CALL(handler.String(*getData<StringPtr>()));
-        } else if constexpr (std::is_same_v<T, ArrayPtr>) {
+            break;
+        case TYPE_BOOL:
+            CALL(handler.Bool(load<bool>()));
+            break;
+        case TYPE_INT32:
+            CALL(handler.Int32(load<int32_t>()));
+            break;
+        case TYPE_INT64:
+            CALL(handler.Int64(load<int64_t>()));
+            break;
+        case TYPE_DOUBLE:
+            CALL(handler.Double(load<double>()));
+            break;
+        case TYPE_STRING_PTR:
+            CALL(handler.String(getString()));
+            break;
+        case TYPE_ARRAY_PTR:
             CALL(handler.StartArray());
-            for (auto& val: *getData<ArrayPtr>()) {
+            for (auto& val: array()) {
                 CALL(val.writeTo(handler));
             }
             CALL(handler.EndArray());
-        } else if constexpr (std::is_same_v<T, ObjectPtr>) {
+            break;
+        case TYPE_OBJECT_PTR:
             CALL(handler.StartObject());
-            for (auto& pair: *getData<ObjectPtr>()) {
-                handler.Key(*pair.first);
+            for (auto& pair: object()) {
+                CALL(handler.Key(pair.first.getString()));
                 CALL(pair.second.writeTo(handler));
             }
             CALL(handler.EndObject());
-        } else {
-            assert(false && "non-exhaustive visitor!");
-            return false;
-        }
-        return true;
-    }, data);
-    return res;
+            break;
+    }
+    return true;
 }
 
 #undef CALL
 
-std::ostream& operator<<(std::ostream& os, const Value& v) {
-    std::visit([&](auto& data) {
-        using T = std::decay_t<decltype(data)>;
-        if constexpr (std::convertible_to<T, std::variant<bool, int32_t, int64_t, double>>) {
-            os << data;
-        } else if constexpr (std::is_same_v<T, StringPtr>) {
-            os << "\"" << *data << "\"";
-        } else {
+inline std::ostream& operator<<(std::ostream& os, const Value& v) {
+    switch (v.getType()) {
+        case TYPE_BOOL:
+            os << v.load<bool>();
+            break;
+        case TYPE_INT32:
+            os << v.load<int32_t>();
+            break;
+        case TYPE_INT64:
+            os << v.load<int64_t>();
+            break;
+        case TYPE_DOUBLE:
+            os << v.load<double>();
+            break;
+        case TYPE_STRING_PTR:
+            os << "\"" << v.getString() << "\"";
+            break;
+        default:
             assert(false && "unsupported type");
-        }
-
-    }, v.data);
+    }
     return os;
 }
 
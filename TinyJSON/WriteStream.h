@@ -3,62 +3,137 @@
 
 #include "noncopyable.h"
 
+#include <algorithm>
+#include <cerrno>
 #include <cstdio>
 #include <vector>
 #include <cstring>
 #include <string_view>
 
-namespace json
-{
+#include <sys/uio.h>
+#include <unistd.h>
 
-class WriteStream : noncopyable
+namespace json
 {
-public:
-    WriteStream() = default;
-
-    virtual void put(char c) = 0;
 
-    virtual void put(const std::string_view&) = 0;
+// What Writer needs from a stream. Writer is a template over its stream,
+// so these calls are resolved at compile time and can be inlined into the serializer.
+// putN() and reserve() of the streams below are for code writing to a stream directly, Writer doesn't need them.
+template<typename T>
+concept WritableStream = requires(T os, std::string_view str) {
+    os.put('\0');
+    os.put(str);
 };
 
-class StringWriteStream : public WriteStream
+// Output to a growing buffer in memory
+class StringWriteStream : noncopyable
 {
 public:
-    void put(char c) override { buffer.push_back(c); }
+    void put(char c) { buffer.push_back(c); }
 
-    void put(const std::string_view& str) override {
-        buffer.insert(buffer.end(), str.begin(), str.end());
-    }
+    void put(std::string_view str) { buffer.insert(buffer.end(), str.begin(), str.end()); }
 
-    void put(const char* str, size_t len) {
-        buffer.insert(buffer.end(), str, str + len);
-    }
+    void put(const char* str, size_t len) { buffer.insert(buffer.end(), str, str + len); }
 
+    // Write c n times
+    void putN(char c, size_t n) { buffer.insert(buffer.end(), n, c); }
 
-    [[nodiscard]] std::string_view get() const {
-        return std::string_view(&*buffer.begin(), buffer.size());
-    }
+    // Make room for n more bytes without reallocating
+    void reserve(size_t n) { buffer.reserve(buffer.size() + n); }
+
+    [[nodiscard]] std::string_view get() const { return std::string_view(buffer.data(), buffer.size()); }
 
 private:
     std::vector<char> buffer;
 };
 
-
-class FileWriteStream : public WriteStream
+// Buffered output to a file descriptor. Output is collected in a user-space buffer and written with write(2),
+// a string which does not fit is written together with the buffer by one writev(2).
+// Call flush() to see the output before the stream is destroyed.
+class FileWriteStream : noncopyable
 {
 public:
-    explicit FileWriteStream(FILE* _output) : output(_output) {}
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+    // Output buffered by "output" so far is flushed first, after that the stream writes to its descriptor
+    // directly, so flush() the stream before writing to "output" again
+    explicit FileWriteStream(FILE* _output, size_t bufferSize = DEFAULT_BUFFER_SIZE)
+            : FileWriteStream(fflush(_output) == 0 ? fileno(_output) : -1, bufferSize) {}
+
+    // The caller keeps the ownership of fd
+    explicit FileWriteStream(int _fd, size_t bufferSize = DEFAULT_BUFFER_SIZE)
+            : fd(_fd), buffer(std::max<size_t>(bufferSize, 1)), ok(_fd >= 0) {}
 
-    void put(char c) override { putc(c, output); }
+    ~FileWriteStream() { flush(); }
 
-    void put(const std::string_view& str) override {
-        fprintf(output, "%.*s", static_cast<int>(str.length()), str.data());
+    void put(char c) {
+        if (used == buffer.size()) flush();
+        buffer[used++] = c;
     }
 
-    void put(const char* str) { fputs(str, output); }
+    void put(std::string_view str) {
+        if (str.size() <= buffer.size() - used) {
+            memcpy(buffer.data() + used, str.data(), str.size());
+            used += str.size();
+        } else {
+            write(str);
+        }
+    }
+
+    void put(const char* str) { put(std::string_view(str)); }
+
+    // Write c n times
+    void putN(char c, size_t n) {
+        while (n > 0) {
+            if (used == buffer.size()) flush();
+            size_t len = std::min(n, buffer.size() - used);
+            memset(buffer.data() + used, c, len);
+            used += len;
+            n -= len;
+        }
+    }
+
+    // Flush now unless n more bytes fit in the buffer, so that the next n bytes are written in one piece
+    void reserve(size_t n) {
+        if (n > buffer.size() - used) flush();
+    }
+
+    // Write out the buffered output
+    void flush() { write(std::string_view()); }
+
+    // False if writing failed, the output is incomplete then
+    [[nodiscard]] bool good() const { return ok; }
 
 private:
-    FILE* output;
+    // Write the buffer followed by str, retrying after short writes and interrupts
+    void write(std::string_view str) {
+        iovec iov[2] = {{buffer.data(), used}, {const_cast<char*>(str.data()), str.size()}};
+        size_t first = 0;
+        used = 0;
+        while (ok && first < 2) {
+            if (iov[first].iov_len == 0) {
+                first++;
+                continue;
+            }
+            ssize_t n = ::writev(fd, iov + first, static_cast<int>(2 - first));
+            if (n < 0) {
+                if (errno != EINTR) ok = false;
+                continue;
+            }
+            auto written = static_cast<size_t>(n);
+            for (; first < 2 && written >= iov[first].iov_len; first++) written -= iov[first].iov_len;
+            if (first < 2) {
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + written;
+                iov[first].iov_len -= written;
+            }
+        }
+    }
+
+private:
+    int fd;
+    std::vector<char> buffer;
+    size_t used = 0;  // bytes of buffer waiting to be written
+    bool ok;
 };
 
 }
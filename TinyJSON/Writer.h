@@ -1,24 +1,29 @@
 #ifndef TINY_JSON_WRITER_H
 #define TINY_JSON_WRITER_H
 
+#include "Number.h"
+#include "Simd.h"
 #include "Value.h"
+#include "WriteStream.h"
 
 #include <cassert>
 #include <cmath>
 #include <cstdint>
 #include <string>
 #include <stack>
-#include <charconv>
+#include <vector>
 
 namespace json
 {
 
-template<typename WriteStream> requires requires(WriteStream os) { os.put(""); }
+template<WritableStream WriteStream>
 class Writer : noncopyable
 {
 public:
     explicit Writer(WriteStream& _os) : os(_os) {}
 
+    Writer(Writer&& rhs) noexcept : noncopyable(), st(std::move(rhs.st)), os(rhs.os) {}
+
     bool Null() {
         prefix(TYPE_NULL);
         os.put("null");
@@ -33,94 +38,33 @@ public:
 
     bool Int32(int32_t i32) {
         prefix(TYPE_INT32);
-
-        char buf[12]{};
-        if (auto res = std::to_chars(buf, buf + sizeof(buf), i32); res.ec != std::errc()) {
-            assert("Failed to convert double to string");
-            return false;
-        }
-        os.put(buf);
+        putInteger(i32);
         return true;
     }
 
     bool Int64(int64_t i64) {
         prefix(TYPE_INT64);
-
-        char buf[21]{};
-        if (auto res = std::to_chars(buf, buf + sizeof(buf), i64); res.ec != std::errc()) {
-            assert("Failed to convert double to string");
-            return false;
-        }
-        os.put(buf);
+        putInteger(i64);
         return true;
     }
 
     bool Double(double d) {
         prefix(TYPE_DOUBLE);
-
-        char buf[32]{};
-
         if (std::isinf(d)) {
-            strcpy(buf, "Infinity");
+            os.put(std::string_view("Infinity"));
         } else if (std::isnan(d)) {
-            strcpy(buf, "NaN");
+            os.put(std::string_view("NaN"));
         } else {
-            if (auto res = std::to_chars(buf, buf + sizeof(buf), d); res.ec != std::errc()) {
-                assert("Failed to convert double to string");
-                return false;
-            }
-
-            // type information loss if ".0" not added
-            // "1.0" -> double 1 -> "1"
-            auto it = std::find_if_not(buf, buf + sizeof(buf), isdigit);
-            if (it == buf + sizeof(buf)) {
-                strcat(buf, ".0");
-            }
+            char buf[number::MAX_NUMBER_LENGTH];
+            char* end = number::writeDouble(d, buf);
+            os.put(std::string_view(buf, static_cast<size_t>(end - buf)));
         }
-
-        os.put(buf);
         return true;
     }
 
     bool String(std::string_view s) {
         prefix(TYPE_STRING_PTR);
-        os.put('"');
-        for (auto c: s) {
-            auto u = static_cast<unsigned char>(c);
-            switch (u) {
-                case '\"':
-                    os.put("\\\"");
-                    break;
-                case '\b':
-                    os.put("\\b");
-                    break;
-                case '\f':
-                    os.put("\\f");
-                    break;
-                case '\n':
-                    os.put("\\n");
-                    break;
-                case '\r':
-                    os.put("\\r");
-                    break;
-                case '\t':
-                    os.put("\\t");
-                    break;
-                case '\\':
-                    os.put("\\\\");
-                    break;
-                default:
-                    if (u < 0x20) {
-                        char buf[7];
-                        snprintf(buf, 7, "\\u%04X", u);
-                        os.put(buf);
-                    } else
-                        os.put(c);
-                    break;
-            }
-        }
-
-        os.put('"');
+        putString(s);
         return true;
     }
 
@@ -133,9 +77,7 @@ public:
 
     bool Key(std::string_view s) {
         prefix(TYPE_STRING_PTR);
-        os.put('"');
-        os.put(s);
-        os.put('"');
+        putString(s);
         return true;
     }
 
@@ -163,6 +105,45 @@ public:
     }
 
 private:
+    // The escape of each byte below 0x20, "" for those written as \u00XX
+    static constexpr std::string_view SHORT_ESCAPES[0x20] = {
+            "", "", "", "", "", "", "", "", "\\b", "\\t", "\\n", "", "\\f", "\\r", "", "",
+            "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "",
+    };
+    static constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+
+    // Write s quoted. Runs of bytes which need no escape are found with the SIMD scan of Reader
+    // and written in one put, only '"', '\\' and control characters are escaped one at a time.
+    void putString(std::string_view s) {
+        os.put('"');
+        const char* p = s.data();
+        const char* end = p + s.size();
+        while (true) {
+            const char* special = simd::scanString(p, end);
+            if (special != p) os.put(std::string_view(p, static_cast<size_t>(special - p)));
+            if (special == end) break;
+            auto u = static_cast<unsigned char>(*special);
+            if (u == '"') {
+                os.put("\\\"");
+            } else if (u == '\\') {
+                os.put("\\\\");
+            } else if (!SHORT_ESCAPES[u].empty()) {
+                os.put(SHORT_ESCAPES[u]);
+            } else {
+                const char escape[] = {'\\', 'u', '0', '0', HEX_DIGITS[u >> 4], HEX_DIGITS[u & 0xF]};
+                os.put(std::string_view(escape, sizeof(escape)));
+            }
+            p = special + 1;
+        }
+        os.put('"');
+    }
+
+    void putInteger(int64_t i64) {
+        char buf[number::MAX_NUMBER_LENGTH];
+        char* end = number::writeInt64(i64, buf);
+        os.put(std::string_view(buf, static_cast<size_t>(end - buf)));
+    }
+
     // The function is used to determine whether a prefix such as ',' or ':' needs to be added,
     // when the value is in an object or array.
     void prefix(ValueType type) {
@@ -194,7 +175,7 @@ private:
     };
 
 private:
-    std::stack<Level> st;
+    std::stack<Level, std::vector<Level>> st;
     WriteStream& os;
 };
 
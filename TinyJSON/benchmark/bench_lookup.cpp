@@ -0,0 +1,98 @@
+#include "TinyJSON/Document.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace json;
+
+// The best of a few runs of fn, in milliseconds
+template<typename Fn>
+static double measure(Fn&& fn) {
+    double best = 0;
+    for (int run = 0; run < 10; run++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (run == 0 || elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+}
+
+static void report(const char* name, double ms, size_t lookups) {
+    printf("%-28s %8.2f ms %8.1f ns/lookup\n", name, ms, ms * 1e6 / static_cast<double>(lookups));
+}
+
+// Sum every number of a document of nested arrays, taking a reference to each array or a counted pointer
+template<bool byPointer>
+static int64_t walk(const Value& v) {
+    if (v.getType() == TYPE_INT32) return v.getData<int32_t>();
+    int64_t sum = 0;
+    if constexpr (byPointer) {
+        for (auto& element: *v.getData<ArrayPtr>()) sum += walk<byPointer>(element);
+    } else {
+        for (auto& element: v.elements()) sum += walk<byPointer>(element);
+    }
+    return sum;
+}
+
+int main() {
+    for (size_t members: {8, 64, 4096}) {
+        std::string json = "{";
+        std::vector<std::string> keys;
+        for (size_t i = 0; i < members; i++) {
+            keys.push_back("field_" + std::to_string(i));
+            json += (i > 0 ? ",\"" : "\"") + keys.back() + "\":" + std::to_string(i);
+        }
+        json += "}";
+        Document doc;
+        if (doc.parse(json) != PARSE_OK) return 1;
+        const Object& object = doc.getObject();
+
+        const size_t lookups = 100000;
+        int64_t sum = 0;
+        printf("%zu members\n", members);
+
+        // what findPair did before the index
+        double ms = measure([&] {
+            for (size_t i = 0; i < lookups; i++) {
+                const std::string& key = keys[i * 7919 % members];
+                for (auto& pair: object) {
+                    if (pair.first.getString() == key) {
+                        sum += pair.second.getData<int32_t>();
+                        break;
+                    }
+                }
+            }
+        });
+        report("  linear scan", ms, lookups);
+
+        ms = measure([&] {
+            for (size_t i = 0; i < lookups; i++) sum += doc[keys[i * 7919 % members]].getData<int32_t>();
+        });
+        report("  operator[](string_view)", ms, lookups);
+
+        constexpr KeyToken field("field_5");
+        ms = measure([&] {
+            for (size_t i = 0; i < lookups; i++) sum += doc[field].getData<int32_t>();
+        });
+        report("  operator[](KeyToken)", ms, lookups);
+        if (sum == 42) printf("\n");
+    }
+
+    // many small arrays, so most of the work is getting at them
+    std::string json = "[";
+    for (int i = 0; i < 200000; i++) json += (i > 0 ? ",[[" : "[[") + std::to_string(i % 100) + "],[1]]";
+    json += "]";
+    Document doc;
+    if (doc.parse(json) != PARSE_OK) return 1;
+    const size_t arrays = 600001;
+    int64_t sum = 0;
+    printf("walk of %zu arrays\n", arrays);
+    double ms = measure([&] { sum += walk<true>(doc); });
+    report("  getData<ArrayPtr>()", ms, arrays);
+    ms = measure([&] { sum += walk<false>(doc); });
+    report("  elements()", ms, arrays);
+    if (sum == 42) printf("\n");
+}
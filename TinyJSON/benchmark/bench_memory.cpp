@@ -0,0 +1,115 @@
+#include "TinyJSON/Document.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace json;
+
+// Count every heap allocation of the process
+static size_t allocations = 0;
+static size_t allocatedBytes = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    allocatedBytes += size;
+    if (void* p = malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+// the arenas of std::pmr allocate with an alignment
+void* operator new(size_t size, std::align_val_t align) {
+    allocations++;
+    allocatedBytes += size;
+    if (void* p = aligned_alloc(static_cast<size_t>(align), (size + static_cast<size_t>(align) - 1) &
+                                                            ~(static_cast<size_t>(align) - 1))) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { free(p); }
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept { free(p); }
+
+// Records with the same keys and a few repeated short values
+static std::string makeRecords(size_t count) {
+    const char* countries[] = {"US", "CA", "MX", "DE"};
+    std::string json = "[";
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) json += ",";
+        json += R"({"precision":"zip","Latitude":37.7668,"Longitude":-122.3959,"Address":"",)";
+        json += R"("City":"SAN FRANCISCO","State":"CA","Zip":")" + std::to_string(94000 + i % 200) + R"(",)";
+        json += R"("Country":")" + std::string(countries[i % 4]) + R"("})";
+    }
+    json += "]";
+    return json;
+}
+
+// makeDocument() returns the document to parse into
+template<typename MakeDocument>
+static void measure(const char* name, const std::string& json, MakeDocument&& makeDocument) {
+    size_t allocationsBefore = allocations;
+    size_t bytesBefore = allocatedBytes;
+    auto start = std::chrono::steady_clock::now();
+    {
+        Document doc = makeDocument();
+        if (doc.parse(json) != PARSE_OK) exit(1);
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    printf("%-24s %10zu allocations %8.1f MB %8.1f ms\n", name, allocations - allocationsBefore,
+           static_cast<double>(allocatedBytes - bytesBefore) / 1e6, elapsed.count());
+}
+
+int main() {
+    std::string json = makeRecords(200000);
+    printf("%zu records, %.1f MB of JSON, %zu bytes per Value\n", size_t{200000},
+           static_cast<double>(json.size()) / 1e6, sizeof(Value));
+    measure("heap", json, [] { return Document(Document::ALLOC_HEAP, Document::INTERN_NONE); });
+    measure("heap, keys", json, [] { return Document(Document::ALLOC_HEAP, Document::INTERN_KEYS); });
+    measure("heap, keys and values", json, [] { return Document(Document::ALLOC_HEAP, Document::INTERN_STRINGS); });
+    measure("arena", json, [] { return Document(Document::ALLOC_ARENA, Document::INTERN_NONE); });
+    measure("arena, keys and values", json, [] { return Document(Document::ALLOC_ARENA, Document::INTERN_STRINGS); });
+    // a pool the caller keeps between documents
+    std::pmr::unsynchronized_pool_resource pool;
+    measure("pool resource", json, [&] { return Document(&pool); });
+    measure("pool resource, again", json, [&] { return Document(&pool); });
+
+    // many small messages, each into a new document or all into the same one
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < 100000; i++) {
+        messages.push_back(R"({"id":)" + std::to_string(i) + R"(,"type":"order.created","items":[{"sku":"A-)" +
+                           std::to_string(i % 100) + R"(","qty":2}],"note":"leave at the door\nthanks"})");
+    }
+    printf("%zu messages\n", messages.size());
+    for (auto mode: {Document::ALLOC_HEAP, Document::ALLOC_ARENA}) {
+        const char* name = mode == Document::ALLOC_HEAP ? "heap" : "arena";
+        size_t allocationsBefore = allocations;
+        auto start = std::chrono::steady_clock::now();
+        for (auto& message: messages) {
+            Document doc(mode);
+            if (doc.parse(message) != PARSE_OK) exit(1);
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        printf("%-24s %10zu allocations %8.1f ms\n", (std::string(name) + ", new").c_str(),
+               allocations - allocationsBefore, elapsed.count());
+
+        allocationsBefore = allocations;
+        start = std::chrono::steady_clock::now();
+        Document doc(mode);
+        for (auto& message: messages) {
+            if (doc.parse(message) != PARSE_OK) exit(1);
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+        printf("%-24s %10zu allocations %8.1f ms\n", (std::string(name) + ", reused").c_str(),
+               allocations - allocationsBefore, elapsed.count());
+    }
+}
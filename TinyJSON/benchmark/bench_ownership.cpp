@@ -0,0 +1,71 @@
+#include "TinyJSON/Document.h"
+#include "TinyJSON/WriteStream.h"
+#include "TinyJSON/Writer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace json;
+
+static std::string makeRecords(size_t count) {
+    std::string json = "[";
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) json += ",";
+        json += R"({"id":)" + std::to_string(i) + R"(,"name":"a name too long to be inline","tags":["a","bc"],)";
+        json += R"("address":{"city":"SAN FRANCISCO","street":"1 Market Street, Suite 100"}})";
+    }
+    json += "]";
+    return json;
+}
+
+// The best of a few runs of fn, in milliseconds
+template<typename Fn>
+static double measure(Fn&& fn) {
+    double best = 0;
+    for (int run = 0; run < 10; run++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (run == 0 || elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+}
+
+int main() {
+    std::string json = makeRecords(100000);
+    printf("%-20s %14s %14s %14s\n", "", "parse, free", "copy records", "write");
+
+    struct Config
+    {
+        const char* name;
+        Document::Allocation mode;
+        Ownership ownership;
+    };
+    for (auto& config: {Config{"heap, shared", Document::ALLOC_HEAP, OWN_SHARED},
+                        Config{"heap, unique", Document::ALLOC_HEAP, OWN_UNIQUE},
+                        Config{"arena, shared", Document::ALLOC_ARENA, OWN_SHARED},
+                        Config{"arena, borrowed", Document::ALLOC_ARENA, OWN_BORROWED}}) {
+        double parse = measure([&] {
+            Document doc(config.mode, config.ownership);
+            if (doc.parse(json) != PARSE_OK) exit(1);
+        });
+
+        Document doc(config.mode, config.ownership);
+        if (doc.parse(json) != PARSE_OK) return 1;
+        // what a handler keeping some of the records does
+        double copy = measure([&] {
+            std::vector<Value> kept;
+            kept.reserve(doc.size());
+            for (auto& record: doc.elements()) kept.push_back(record);
+        });
+        double write = measure([&] {
+            StringWriteStream os;
+            Writer writer(os);
+            doc.writeTo(writer);
+        });
+        printf("%-20s %11.2f ms %11.2f ms %11.2f ms\n", config.name, parse, copy, write);
+    }
+}
@@ -0,0 +1,130 @@
+#include "TinyJSON/Document.h"
+#include "TinyJSON/WriteStream.h"
+#include "TinyJSON/Writer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace json;
+
+// The stream interface before it became a concept, every put() is a virtual call
+class VirtualWriteStream : noncopyable
+{
+public:
+    virtual ~VirtualWriteStream() = default;
+
+    virtual void put(char c) = 0;
+
+    virtual void put(std::string_view str) = 0;
+};
+
+class VirtualStringWriteStream : public VirtualWriteStream
+{
+public:
+    void put(char c) override { buffer.push_back(c); }
+
+    void put(std::string_view str) override { buffer.insert(buffer.end(), str.begin(), str.end()); }
+
+    [[nodiscard]] size_t size() const { return buffer.size(); }
+
+private:
+    std::vector<char> buffer;
+};
+
+static std::string makeInput(size_t count) {
+    std::string json = "[";
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) json += ",";
+        json += R"({"id":)" + std::to_string(i) +
+                R"(,"name":"item","price":12.5,"tags":["a","bc","def"],"stock":{"count":7,"available":true}})";
+    }
+    json += "]";
+    return json;
+}
+
+// Mostly long text fields, with a few escapes
+static std::string makeTextInput(size_t count) {
+    std::string text;
+    while (text.size() < 2000) text += "The quick brown fox jumps over the lazy dog. ";
+    text += R"(\"quoted\"\n)";
+    std::string json = "[";
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) json += ",";
+        json += R"({"id":)" + std::to_string(i) + R"(,"body":")" + text + R"("})";
+    }
+    json += "]";
+    return json;
+}
+
+// The best of a few runs of fn, in milliseconds
+template<typename Fn>
+static double measure(Fn&& fn) {
+    double best = 0;
+    for (int run = 0; run < 10; run++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (run == 0 || elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+}
+
+static void report(const char* name, double ms, size_t bytes) {
+    printf("%-28s %8.2f ms %8.1f MB/s\n", name, ms, static_cast<double>(bytes) / 1e3 / ms);
+}
+
+int main() {
+    std::string json = makeInput(100000);
+    Document doc;
+    if (doc.parse(json) != PARSE_OK) return 1;
+
+    size_t bytes = 0;
+    double ms = measure([&] {
+        VirtualStringWriteStream os;
+        VirtualWriteStream& base = os;
+        Writer writer(base);
+        doc.writeTo(writer);
+        bytes = os.size();
+    });
+    report("virtual stream", ms, bytes);
+
+    ms = measure([&] {
+        StringWriteStream os;
+        Writer writer(os);
+        doc.writeTo(writer);
+        bytes = os.get().size();
+    });
+    report("StringWriteStream", ms, bytes);
+
+    ms = measure([&] {
+        StringWriteStream os;
+        os.reserve(json.size());
+        Writer writer(os);
+        doc.writeTo(writer);
+        bytes = os.get().size();
+    });
+    report("StringWriteStream, reserved", ms, bytes);
+
+    FILE* null = fopen("/dev/null", "w");
+    if (null == nullptr) return 1;
+    ms = measure([&] {
+        FileWriteStream os(null);
+        Writer writer(os);
+        doc.writeTo(writer);
+    });
+    report("FileWriteStream /dev/null", ms, bytes);
+    fclose(null);
+
+    std::string text = makeTextInput(10000);
+    Document textDoc;
+    if (textDoc.parse(text) != PARSE_OK) return 1;
+    ms = measure([&] {
+        StringWriteStream os;
+        Writer writer(os);
+        textDoc.writeTo(writer);
+        bytes = os.get().size();
+    });
+    report("StringWriteStream, text", ms, bytes);
+}
@@ -1,4 +1,5 @@
 #include "TinyJSON/Document.h"
+#include <string>
 #include <gtest/gtest.h>
 
 using namespace json;
@@ -52,6 +53,7 @@ TEST(json_error, num_too_big) {
     TEST_ERROR(err, "-1e309");
     TEST_ERROR(err, "9223372036854775808");
     TEST_ERROR(err, "-9223372036854775809");
+    TEST_ERROR(err, "123456789012345678901234567890");
     TEST_ERROR(err, "9223372036854775808i64");
     TEST_ERROR(err, "-9223372036854775809i64");
     TEST_ERROR(err, "12345678901i32");
@@ -62,6 +64,7 @@ TEST(json_error, bad_string_char) {
     ParseError err = PARSE_BAD_STRING_CHAR;
     TEST_ERROR(err, "\"abcd\1efg\"");
     TEST_ERROR(err, "\"\b\"");
+    TEST_ERROR(err, "\"0123456789abcdef0123456789abcdef0123456789\x1f\"");
 }
 
 TEST(json_error, bad_string_escape) {
@@ -120,6 +123,55 @@ TEST(json_error, miss_comma_or_curly_bracket) {
     TEST_ERROR(err, "{\"hehe\":false, \"\":\"蛤\"");
 }
 
+TEST(json_error, depth_exceeded) {
+    ParseError err = PARSE_DEPTH_EXCEEDED;
+    // deep enough to overflow the call stack of a recursive parser
+    TEST_ERROR(err, std::string(100000, '['));
+    TEST_ERROR(err, std::string(Reader::DEFAULT_MAX_DEPTH + 1, '['));
+    std::string limit(Reader::DEFAULT_MAX_DEPTH, '[');
+    limit += std::string(Reader::DEFAULT_MAX_DEPTH, ']');
+    TEST_ERROR(PARSE_OK, limit);
+
+    std::string nested;
+    for (int i = 0; i < 3; i++) nested += "{\"a\":[";
+    nested += "null";
+    for (int i = 0; i < 3; i++) nested += "]}";
+
+    Document doc;
+    StringReadStream deep(nested);
+    EXPECT_EQ(PARSE_OK, doc.parseStream(deep, 6));
+    Document doc2;
+    StringReadStream tooDeep(nested);
+    ParseResult res = doc2.parseStream(tooDeep, 5);
+    EXPECT_EQ(err, res.err());
+    EXPECT_EQ(17u, res.getOffset());
+}
+
+#define TEST_OFFSET(expectErr, expectOffset, expectLine, expectColumn, json) \
+    do {                                                                     \
+        Document doc;                                                        \
+        ParseResult res = doc.parse(json);                                   \
+        EXPECT_EQ(expectErr, res.err());                                     \
+        EXPECT_EQ(expectOffset, res.getOffset());                            \
+        EXPECT_EQ(expectLine, res.line(json));                               \
+        EXPECT_EQ(expectColumn, res.column(json));                           \
+    } while (false)
+
+TEST(json_error, offset) {
+    TEST_OFFSET(PARSE_OK, 0, 1, 1, "[1, 2]");
+    TEST_OFFSET(PARSE_EXPECT_VALUE, 3, 2, 2, " \n ");
+    TEST_OFFSET(PARSE_BAD_VALUE, 0, 1, 1, "nulr");
+    TEST_OFFSET(PARSE_ROOT_NOT_SINGULAR, 5, 1, 6, "true false");
+    TEST_OFFSET(PARSE_NUMBER_TOO_BIG, 1, 1, 2, "[1e309]");
+    TEST_OFFSET(PARSE_BAD_STRING_CHAR, 5, 1, 6, "\"abcd\1efg\"");
+    TEST_OFFSET(PARSE_BAD_STRING_ESCAPE, 4, 1, 5, "\"xx\\a\"");
+    TEST_OFFSET(PARSE_MISS_QUOTATION_MARK, 4, 1, 5, "\"wtf");
+    TEST_OFFSET(PARSE_MISS_COMMA_OR_SQUARE_BRACKET, 11, 3, 5, "[\n  1,\n  2 3]");
+    TEST_OFFSET(PARSE_MISS_KEY, 14, 1, 15, "{\"hehe\":null, }");
+    TEST_OFFSET(PARSE_MISS_COLON, 7, 1, 8, "{\"hehe\"}");
+    TEST_OFFSET(PARSE_MISS_COMMA_OR_CURLY_BRACKET, 17, 2, 9, "{\"hehe\":\n  false ]");
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,159 @@
+#include "TinyJSON/ParallelReader.h"
+#include "TinyJSON/WriteStream.h"
+#include "TinyJSON/Writer.h"
+#include "example/sample.h"
+#include <gtest/gtest.h>
+#include <mutex>
+#include <string>
+
+using namespace json;
+
+// Enough lines for several batches per worker
+static std::string makeLines(size_t count) {
+    std::string input;
+    for (size_t i = 0; i < count; i++) {
+        if (i % 1000 == 7) {
+            input += "{\"id\": " + std::to_string(i) + ", \"bad\": }\n";
+        } else if (i % 1000 == 8) {
+            input += "  \r\n";
+        } else {
+            input += "{\"id\": " + std::to_string(i) + ", \"tags\": [\"a\", \"b\"]}\r\n";
+        }
+    }
+    return input;
+}
+
+TEST(json_parallel, lines) {
+    const size_t count = 20000;
+    std::string input = makeLines(count);
+    for (unsigned threads: {1u, 4u, 0u}) {
+        auto lines = ParallelReader::parseLines(input, threads);
+        ASSERT_EQ(lines.size(), count - count / 1000);
+        size_t expect = 0;
+        for (auto& line: lines) {
+            if (expect % 1000 == 8) expect++;
+            EXPECT_EQ(line.number, expect);
+            if (expect % 1000 == 7) {
+                EXPECT_EQ(line.result.err(), PARSE_BAD_VALUE);
+                EXPECT_EQ(line.result.getOffset(), std::to_string(expect).size() + 16);
+            } else {
+                ASSERT_EQ(line.result, PARSE_OK);
+                EXPECT_EQ(line.document["id"].getData<int32_t>(), static_cast<int32_t>(expect));
+            }
+            expect++;
+        }
+    }
+
+    // no trailing newline, blank lines only
+    auto lines = ParallelReader::parseLines("1\n\n[2]");
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[1].number, 2u);
+    EXPECT_EQ(lines[1].document[0].getData<int32_t>(), 2);
+    EXPECT_TRUE(ParallelReader::parseLines("\n \n\t").empty());
+}
+
+TEST(json_parallel, lines_unordered) {
+    const size_t count = 20000;
+    std::string input = makeLines(count);
+    std::mutex mutex;
+    std::vector<bool> seen(count);
+    size_t errors = 0;
+    ParallelReader::parseLinesUnordered(input, [&](ParallelReader::Line&& line) {
+        std::lock_guard lock(mutex);
+        EXPECT_FALSE(seen[line.number]);
+        seen[line.number] = true;
+        if (line.result != PARSE_OK) errors++;
+        else EXPECT_EQ(line.document["id"].getData<int32_t>(), static_cast<int32_t>(line.number));
+    }, 4);
+    EXPECT_EQ(errors, count / 1000);
+    for (size_t i = 0; i < count; i++) EXPECT_EQ(seen[i], i % 1000 != 8);
+}
+
+// Must give the same document or the same error as a sequential parse
+#define TEST_ARRAY(json, threads)                                              \
+    do {                                                                       \
+        const std::string text(json);                                          \
+        Document expect;                                                       \
+        ParseResult expectRes = expect.parse(text);                            \
+        Document doc(Document::ALLOC_ARENA);                                   \
+        ParseResult res = ParallelReader::parseArray(text, doc, threads);      \
+        EXPECT_EQ(expectRes.err(), res.err()) << text.substr(0, 100);          \
+        EXPECT_EQ(expectRes.getOffset(), res.getOffset()) << text.substr(0, 100); \
+        if (expectRes == PARSE_OK) {                                           \
+            StringWriteStream os1, os2;                                        \
+            Writer writer1(os1), writer2(os2);                                 \
+            expect.writeTo(writer1);                                           \
+            doc.writeTo(writer2);                                              \
+            EXPECT_EQ(os1.get(), os2.get());                                   \
+        }                                                                      \
+    } while (false)
+
+TEST(json_parallel, array) {
+    std::string big = "[";
+    for (size_t i = 0; i < 20000; i++) {
+        big += "{\"id\": " + std::to_string(i) + ", \"s\": \"a,]\\\"[b\", \"a\": [1, {\"x\": null}]},\n";
+    }
+    big += " 1.5 ]";
+
+    for (unsigned threads: {1u, 4u}) {
+        TEST_ARRAY(big, threads);
+        TEST_ARRAY(sample[0], threads);
+        TEST_ARRAY("[]", threads);
+        TEST_ARRAY(" [ ] ", threads);
+        TEST_ARRAY("[1]", threads);
+        TEST_ARRAY("{\"a\": [1, 2]}", threads);
+        TEST_ARRAY("42", threads);
+        TEST_ARRAY("", threads);
+
+        // errors anywhere in the array
+        std::string bad = big;
+        bad[bad.size() / 2] = '}';
+        TEST_ARRAY(bad, threads);
+        TEST_ARRAY(big.substr(0, big.size() - 1), threads);
+        TEST_ARRAY(big + " 2", threads);
+        TEST_ARRAY("[1, , 2]", threads);
+        TEST_ARRAY("[1, 2, ]", threads);
+        TEST_ARRAY("[1, 2}", threads);
+        TEST_ARRAY("[[1, 2], [3}]", threads);
+
+        // errors inside containers opened by an element, in a range which is not the first
+        std::string prefix = "[";
+        for (size_t i = 0; i < 2000; i++) prefix += "{\"a\": [1, 2, 3]},";
+        TEST_ARRAY(prefix + "{\"a\": tru}, 1]", threads);
+        TEST_ARRAY(prefix + "[[1, [2, x]], 3]]", threads);
+        TEST_ARRAY(prefix + "{\"a\": [{\"b\": 1e}]}]", threads);
+    }
+
+    // the elements outlive the partial documents and their arenas
+    Document doc(Document::ALLOC_ARENA);
+    ASSERT_EQ(ParallelReader::parseArray(big, doc, 4), PARSE_OK);
+    EXPECT_EQ(doc.getData<ArrayPtr>()->size(), 20001u);
+    EXPECT_EQ(doc[19999]["id"].getData<int32_t>(), 19999);
+    EXPECT_EQ(doc[3]["s"].getString(), "a,]\"[b");
+    Document moved = std::move(doc);
+    EXPECT_EQ(moved[10]["a"][1]["x"].getType(), TYPE_NULL);
+    // borrowed nodes, and pooled strings, from the arenas of the partial documents
+    Document borrowed(Document::ALLOC_ARENA, OWN_BORROWED, Document::INTERN_STRINGS);
+    ASSERT_EQ(ParallelReader::parseArray(big, borrowed, 4), PARSE_OK);
+    EXPECT_EQ(borrowed[19999].getOwnership(), OWN_BORROWED);
+    StringWriteStream os1, os2;
+    Writer writer1(os1), writer2(os2);
+    moved.writeTo(writer1);
+    borrowed.writeTo(writer2);
+    EXPECT_EQ(os1.get(), os2.get());
+
+    // the workers share a thread-safe resource
+    std::pmr::synchronized_pool_resource pool;
+    Document pooled(&pool);
+    ASSERT_EQ(ParallelReader::parseArray(big, pooled, 4), PARSE_OK);
+    EXPECT_EQ(pooled[19999]["a"].getArray().get_allocator().resource(), &pool);
+    StringWriteStream os3;
+    Writer writer3(os3);
+    pooled.writeTo(writer3);
+    EXPECT_EQ(os1.get(), os3.get());
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,119 @@
+#include "TinyJSON/Document.h"
+#include "TinyJSON/PushReader.h"
+#include "TinyJSON/WriteStream.h"
+#include "TinyJSON/Writer.h"
+#include "example/sample.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace json;
+
+// PushReader must produce the same events and the same errors as Reader, however the input is cut
+#define TEST_SAME(json)                                                             \
+    do {                                                                            \
+        const std::string text(json);                                               \
+        StringReadStream is1(text);                                                 \
+        StringWriteStream os1;                                                      \
+        Writer writer1(os1);                                                        \
+        ParseResult res1 = Reader::parse(is1, writer1);                             \
+        for (size_t chunkSize: {1, 2, 3, 7, 64, 100000}) {                          \
+            StringWriteStream os2;                                                  \
+            Writer writer2(os2);                                                    \
+            PushReader reader(writer2);                                             \
+            for (size_t i = 0; i < text.size(); i += chunkSize) {                   \
+                reader.feed(std::string_view(text).substr(i, chunkSize));           \
+            }                                                                       \
+            ParseResult res2 = reader.finish();                                     \
+            EXPECT_EQ(res1.err(), res2.err()) << chunkSize << ": " << text;         \
+            EXPECT_EQ(res1.getOffset(), res2.getOffset()) << chunkSize << ": " << text; \
+            if (res1 == PARSE_OK) {                                                 \
+                EXPECT_EQ(os1.get(), os2.get()) << chunkSize << ": " << text;       \
+            }                                                                       \
+        }                                                                           \
+    } while (false)
+
+TEST(json_push, valid) {
+    TEST_SAME("null");
+    TEST_SAME(" true ");
+    TEST_SAME("-1.5e10");
+    TEST_SAME("123i64");
+    TEST_SAME("NaN");
+    TEST_SAME("\"abc\"");
+    TEST_SAME("[]");
+    TEST_SAME("{}");
+    TEST_SAME("[ { } , [ ] , { \"a\" : [ 1 , 2 ] } ]");
+    TEST_SAME("{\"n\":null,\"f\":false,\"t\":true,\"i\":123,\"s\":\"abc\",\"a\":[1,2,3],\"o\":{\"1\":1,\"2\":2}}");
+    TEST_SAME("[\"a,b:c{d}e[f]\", \"\\\"[\\\\\", \"\\\\\\\\\\\"\", \"\\ud834\\udd1e\"]");
+    for (auto& s : sample) {
+        TEST_SAME(s);
+    }
+}
+
+TEST(json_push, error) {
+    TEST_SAME("");
+    TEST_SAME(" \r\n");
+    TEST_SAME("nulr");
+    TEST_SAME("nul");
+    TEST_SAME("-");
+    TEST_SAME("[null,]");
+    TEST_SAME("true false");
+    TEST_SAME("1.0.1");
+    TEST_SAME("[] []");
+    TEST_SAME("1e309");
+    TEST_SAME("\"abcd\1efg\"");
+    TEST_SAME("\"xx\\a\"");
+    TEST_SAME("\"\\uDBFF\\uFFFF\"");
+    TEST_SAME("\"wtf");
+    TEST_SAME("[1, 2");
+    TEST_SAME("[");
+    TEST_SAME("[truefalse]");
+    TEST_SAME("[1 2]");
+    TEST_SAME("[1:2]");
+    TEST_SAME("{");
+    TEST_SAME("{\"a\"");
+    TEST_SAME("{\"a\":");
+    TEST_SAME("{:null}");
+    TEST_SAME("{\"hehe\":null, }");
+    TEST_SAME("{\"hehe\"}");
+    TEST_SAME("{\"hehe\"x:1}");
+    TEST_SAME("{\"hehe\":null]");
+    TEST_SAME("{\"hehe\":nullx}");
+    TEST_SAME("[\"a\"b]");
+    TEST_SAME(std::string(Reader::DEFAULT_MAX_DEPTH + 1, '['));
+}
+
+TEST(json_push, incremental) {
+    // events are sent as soon as they are complete
+    Document doc;
+    StringWriteStream os;
+    Writer writer(os);
+    PushReader reader(writer);
+    EXPECT_EQ(reader.feed("{\"ke"), PARSE_OK);
+    EXPECT_EQ(os.get(), "{");
+    EXPECT_EQ(reader.feed("y\": [12"), PARSE_OK);
+    EXPECT_EQ(os.get(), "{\"key\":[");
+    EXPECT_EQ(reader.feed("3, \"a\\"), PARSE_OK);
+    EXPECT_EQ(os.get(), "{\"key\":[123");
+    EXPECT_EQ(reader.feed("\"b\"]}"), PARSE_OK);
+    EXPECT_EQ(reader.finish(), PARSE_OK);
+    EXPECT_EQ(os.get(), "{\"key\":[123,\"a\\\"b\"]}");
+
+    // a document handler, reused for another document
+    PushReader docReader(doc);
+    EXPECT_EQ(docReader.feed("[1, 2"), PARSE_OK);
+    ParseResult res = docReader.feed("x]");
+    EXPECT_EQ(res.err(), PARSE_MISS_COMMA_OR_SQUARE_BRACKET);
+    EXPECT_EQ(res.getOffset(), 5u);
+    EXPECT_EQ(docReader.finish(), PARSE_MISS_COMMA_OR_SQUARE_BRACKET);
+    docReader.reset();
+    doc.reset();
+    EXPECT_EQ(docReader.feed("{\"City\": \"SAN "), PARSE_OK);
+    EXPECT_EQ(docReader.feed("FRANCISCO\"}"), PARSE_OK);
+    EXPECT_EQ(docReader.finish(), PARSE_OK);
+    EXPECT_EQ(doc["City"].getString(), "SAN FRANCISCO");
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,6 +1,7 @@
 #include "TinyJSON/Document.h"
 #include "TinyJSON/WriteStream.h"
 #include "TinyJSON/Writer.h"
+#include "example/sample.h"
 #include "gtest/gtest.h"
 
 using namespace json;
@@ -16,10 +17,30 @@ using namespace json;
         EXPECT_EQ(json, os.get());        \
     } while (false)
 
+#define TEST_ROUNDTRIP_INSITU(json)                    \
+    do {                                               \
+        std::string buffer(json);                      \
+        InsituStringStream is(buffer);                 \
+        StringWriteStream os;                          \
+        Writer writer(os);                             \
+        EXPECT_EQ(Reader::parse(is, writer), PARSE_OK); \
+        EXPECT_EQ(json, os.get());                     \
+    } while (false)
+
 TEST(json_round, number) {
     TEST_ROUNDTRIP("0");
     TEST_ROUNDTRIP("1");
     TEST_ROUNDTRIP("-1");
+    TEST_ROUNDTRIP("0.0");
+    TEST_ROUNDTRIP("-0.0");
+    TEST_ROUNDTRIP("1.0");
+    TEST_ROUNDTRIP("-1.0");
+    TEST_ROUNDTRIP("2147483647");
+    TEST_ROUNDTRIP("-2147483648");
+    TEST_ROUNDTRIP("9223372036854775807");
+    TEST_ROUNDTRIP("-9223372036854775808");
+    TEST_ROUNDTRIP("Infinity");
+    TEST_ROUNDTRIP("NaN");
     TEST_ROUNDTRIP("10086.9527");
     TEST_ROUNDTRIP("2.345e+100");
     TEST_ROUNDTRIP("-1.11e-10");
@@ -45,6 +66,9 @@ TEST(json_round, string) {
     TEST_ROUNDTRIP("\"Hello\\nWorld\"");
     TEST_ROUNDTRIP("\"\\\" \\\\ / \\b \\f \\n \\r \\t\"");
     TEST_ROUNDTRIP("\"Hello\\u0000World\"");
+    TEST_ROUNDTRIP("\"\\u0001\\u001F\"");
+    // escapes on both sides of the 16 and 32 byte blocks of the scan
+    TEST_ROUNDTRIP("\"0123456789abcdefghijklmnopqrst\\\"uv\\n0123456789abcdefghijklmnopqrstuvwxyz\\\\\"");
 }
 
 TEST(json_round, array) {
@@ -54,10 +78,181 @@ TEST(json_round, array) {
 
 TEST(json_round, object) {
     TEST_ROUNDTRIP("{}");
+    TEST_ROUNDTRIP("{\"a\\\"b\\\\c\\n\\u0002\":\"\\t\"}");
     TEST_ROUNDTRIP(
         "{\"n\":null,\"f\":false,\"t\":true,\"i\":123,\"s\":\"abc\",\"a\":[1,2,3],\"o\":{\"1\":1,\"2\":2,\"3\":3}}");
 }
 
+TEST(json_round, insitu) {
+    TEST_ROUNDTRIP_INSITU("\"\"");
+    TEST_ROUNDTRIP_INSITU("\"Hello\"");
+    TEST_ROUNDTRIP_INSITU("\"Hello\\nWorld\"");
+    TEST_ROUNDTRIP_INSITU("\"\\\" \\\\ / \\b \\f \\n \\r \\t\"");
+    TEST_ROUNDTRIP_INSITU("\"Hello\\u0000World\"");
+    TEST_ROUNDTRIP_INSITU("[\"a\\tb\",{\"key\":\"0123456789abcdef0123456789abcdef\\n0123456789abcdef\"}]");
+
+    // unescaped strings are views into the source buffer
+    std::string buffer = R"({"key": "G clef \ud834\udd1e!"})";
+    InsituStringStream is(buffer);
+    Document doc;
+    EXPECT_EQ(doc.parseStream(is), PARSE_OK);
+    EXPECT_EQ(doc["key"].getString(), "G clef \xF0\x9D\x84\x9E!");
+    EXPECT_EQ(std::string_view(buffer).substr(2, 3), "key");
+    EXPECT_EQ(std::string_view(buffer).substr(9, 12), "G clef \xF0\x9D\x84\x9E!");
+}
+
+// Records whether each string handed over by Reader is a view into the input
+struct ViewChecker
+{
+    std::string_view input;
+    std::vector<bool> isView;
+
+    bool Null() { return true; }
+    bool Bool(bool) { return true; }
+    bool Int32(int32_t) { return true; }
+    bool Int64(int64_t) { return true; }
+    bool Double(double) { return true; }
+    bool String(std::string_view s) { return check(s); }
+    bool Key(std::string_view s) { return check(s); }
+    bool StartObject() { return true; }
+    bool EndObject() { return true; }
+    bool StartArray() { return true; }
+    bool EndArray() { return true; }
+
+    bool check(std::string_view s) {
+        isView.push_back(s.data() >= input.data() && s.data() + s.size() <= input.data() + input.size());
+        return true;
+    }
+};
+
+TEST(json_round, zero_copy) {
+    std::string_view json = R"({"plain": "text", "escaped": "a\tb", "": ""})";
+    StringReadStream is(json);
+    ViewChecker checker{json, {}};
+    EXPECT_EQ(Reader::parse(is, checker), PARSE_OK);
+    EXPECT_EQ(checker.isView, (std::vector<bool>{true, true, true, false, true, true}));
+}
+
+TEST(json_round, mmap) {
+    std::string_view json = R"({"plain": "text", "escaped": "a\tb", "array": [1, 2.5, null]})";
+    FILE* file = tmpfile();
+    ASSERT_NE(file, nullptr);
+    fwrite(json.data(), 1, json.size(), file);
+    fflush(file);
+
+    MmapReadStream is(fileno(file));
+    fclose(file);
+    ASSERT_TRUE(is.good());
+    StringWriteStream os;
+    Writer writer(os);
+    EXPECT_EQ(Reader::parse(is, writer), PARSE_OK);
+    EXPECT_EQ(os.get(), R"({"plain":"text","escaped":"a\tb","array":[1,2.5,null]})");
+
+    MmapReadStream missing("/nonexistent/tiny.json");
+    EXPECT_FALSE(missing.good());
+    Document doc;
+    EXPECT_EQ(doc.parseStream(missing), PARSE_EXPECT_VALUE);
+}
+
+TEST(json_round, chunked) {
+    std::vector<std::string> inputs(std::begin(sample), std::end(sample));
+    inputs.emplace_back(R"([ "a\tb" , -1.25e-3 , 12345678901234567890123.5, "\ud834\udd1e", true, NaN ])");
+    inputs.emplace_back("{\"key\": [1, 2, ]}");
+
+    // tiny buffers put every token across a refill
+    for (size_t bufferSize: {1, 3, 7, 64, 4096}) {
+        for (auto& json: inputs) {
+            StringReadStream expectIs(json);
+            StringWriteStream expectOs;
+            Writer expectWriter(expectOs);
+            ParseResult expect = Reader::parse(expectIs, expectWriter);
+
+            FILE* file = tmpfile();
+            ASSERT_NE(file, nullptr);
+            fwrite(json.data(), 1, json.size(), file);
+            rewind(file);
+            ChunkedReadStream is(file, bufferSize);
+            StringWriteStream os;
+            Writer writer(os);
+            ParseResult res = Reader::parse(is, writer);
+            fclose(file);
+
+            EXPECT_EQ(expect.err(), res.err()) << bufferSize << json;
+            EXPECT_EQ(expect.getOffset(), res.getOffset()) << bufferSize << json;
+            if (expect == PARSE_OK) {
+                EXPECT_EQ(expectOs.get(), os.get()) << bufferSize << json;
+            }
+        }
+    }
+}
+
+TEST(json_round, file_write) {
+    std::string json(sample[0]);
+    Document doc;
+    ASSERT_EQ(doc.parse(json), PARSE_OK);
+    StringWriteStream expect;
+    Writer expectWriter(expect);
+    doc.writeTo(expectWriter);
+
+    // small buffers write most strings with writev, past the buffered bytes
+    for (size_t bufferSize: {size_t{1}, size_t{7}, size_t{64}, size_t{4096}, FileWriteStream::DEFAULT_BUFFER_SIZE}) {
+        FILE* file = tmpfile();
+        ASSERT_NE(file, nullptr);
+        fputs("prefix ", file);
+        {
+            FileWriteStream os(file, bufferSize);
+            Writer writer(os);
+            doc.writeTo(writer);
+            os.put(std::string(3 * bufferSize, 'x'));
+            os.flush();
+            EXPECT_TRUE(os.good());
+            os.put('!');
+        }
+        rewind(file);
+        std::string written;
+        for (int c; (c = fgetc(file)) != EOF;) written.push_back(static_cast<char>(c));
+        fclose(file);
+        EXPECT_EQ(written, "prefix " + std::string(expect.get()) + std::string(3 * bufferSize, 'x') + "!");
+    }
+
+    FileWriteStream closed(-1);
+    closed.put("lost");
+    closed.flush();
+    EXPECT_FALSE(closed.good());
+}
+
+TEST(json_round, file_write_put_n) {
+    // runs which start just before the end of the buffer and fill it several times over
+    const size_t size = FileWriteStream::DEFAULT_BUFFER_SIZE;
+    std::string expect(size - 10, 'a');
+    FILE* file = tmpfile();
+    ASSERT_NE(file, nullptr);
+    {
+        FileWriteStream os(file);
+        os.put(expect);
+        os.putN('b', 100);
+        expect.append(100, 'b');
+        os.reserve(size - 80);
+        os.put("c");
+        expect += 'c';
+        os.putN('d', 3 * size + 5);
+        expect.append(3 * size + 5, 'd');
+        os.putN('e', 0);
+        os.flush();
+        EXPECT_TRUE(os.good());
+    }
+    rewind(file);
+    std::string written;
+    for (int c; (c = fgetc(file)) != EOF;) written.push_back(static_cast<char>(c));
+    fclose(file);
+    EXPECT_EQ(written, expect);
+
+    StringWriteStream os;
+    os.putN('x', 3);
+    os.put("y");
+    EXPECT_EQ(os.get(), "xxxy");
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,90 @@
+#include "TinyJSON/Document.h"
+#include "TinyJSON/StructuralReader.h"
+#include "TinyJSON/WriteStream.h"
+#include "TinyJSON/Writer.h"
+#include "example/sample.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace json;
+
+// StructuralReader must produce the same events and the same errors as Reader
+#define TEST_SAME(json)                                                     \
+    do {                                                                    \
+        const std::string text(json);                                       \
+        StringReadStream is1(text);                                         \
+        StringWriteStream os1;                                              \
+        Writer writer1(os1);                                                \
+        ParseError err1 = Reader::parse(is1, writer1);                      \
+        StringReadStream is2(text);                                         \
+        StringWriteStream os2;                                              \
+        Writer writer2(os2);                                                \
+        ParseError err2 = StructuralReader::parse(is2, writer2);            \
+        EXPECT_EQ(err1, err2) << text;                                      \
+        if (err1 == PARSE_OK) {                                             \
+            EXPECT_EQ(os1.get(), os2.get()) << text;                        \
+        }                                                                   \
+    } while (false)
+
+TEST(json_structural, valid) {
+    TEST_SAME("null");
+    TEST_SAME(" true ");
+    TEST_SAME("-1.5e10");
+    TEST_SAME("123i64");
+    TEST_SAME("NaN");
+    TEST_SAME("\"abc\"");
+    TEST_SAME("[]");
+    TEST_SAME("{}");
+    TEST_SAME("[ { } , [ ] , { \"a\" : [ 1 , 2 ] } ]");
+    TEST_SAME("{\"n\":null,\"f\":false,\"t\":true,\"i\":123,\"s\":\"abc\",\"a\":[1,2,3],\"o\":{\"1\":1,\"2\":2}}");
+    TEST_SAME("[\"a,b:c{d}e[f]\", \"\\\"[\\\\\", \"\\\\\\\\\\\"\"]");
+    for (auto& s : sample) {
+        TEST_SAME(s);
+    }
+}
+
+TEST(json_structural, block_boundaries) {
+    // put quotes, backslashes and structural characters on every offset around the 64-byte boundaries
+    for (size_t pad = 0; pad < 130; pad++) {
+        std::string json = "[\"" + std::string(pad, 'x') + "\\\\\\\"\\\\\",{\"k\\\"\":[" + std::string(pad % 7, ' ') + "1]}]";
+        TEST_SAME(json);
+        std::string prefix(1, '[');
+        prefix.append(pad, ' ');
+        TEST_SAME(prefix + "\"" + std::string(pad, '\\') + "\"]");
+        TEST_SAME(prefix + "\"" + std::string(pad / 2 * 2, '\\') + "\", 1]");
+        TEST_SAME(prefix + "true,false,null," + std::to_string(pad) + "]");
+    }
+}
+
+TEST(json_structural, error) {
+    TEST_SAME("");
+    TEST_SAME(" \r\n");
+    TEST_SAME("nulr");
+    TEST_SAME("[null,]");
+    TEST_SAME("true false");
+    TEST_SAME("1.0.1");
+    TEST_SAME("[] []");
+    TEST_SAME("1e309");
+    TEST_SAME("\"abcd\1efg\"");
+    TEST_SAME("\"xx\\a\"");
+    TEST_SAME("\"\\uDBFF\\uFFFF\"");
+    TEST_SAME("\"wtf");
+    TEST_SAME("[1, 2");
+    TEST_SAME("[truefalse]");
+    TEST_SAME("[1 2]");
+    TEST_SAME("{");
+    TEST_SAME("{:null}");
+    TEST_SAME("{\"hehe\":null, }");
+    TEST_SAME("{\"hehe\"}");
+    TEST_SAME("{\"hehe\"x:1}");
+    TEST_SAME("{\"hehe\":null]");
+    TEST_SAME("{\"hehe\":nullx}");
+    TEST_SAME("[\"a\"b]");
+    TEST_SAME(std::string(100000, '['));
+    TEST_SAME(std::string(Reader::DEFAULT_MAX_DEPTH, '[') + std::string(Reader::DEFAULT_MAX_DEPTH, ']'));
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,105 @@
+#include "TinyJSON/Document.h"
+#include "TinyJSON/StructuralReader.h"
+#include "TinyJSON/TapeDocument.h"
+#include "TinyJSON/WriteStream.h"
+#include "TinyJSON/Writer.h"
+#include "example/sample.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+
+using namespace json;
+using namespace std::string_view_literals;
+
+// Writing a TapeDocument must give the same output as writing a Document
+#define TEST_SAME_AS_DOCUMENT(json)                        \
+    do {                                                   \
+        Document doc;                                      \
+        EXPECT_EQ(doc.parse(json), PARSE_OK);              \
+        StringWriteStream os1;                             \
+        Writer writer1(os1);                               \
+        doc.writeTo(writer1);                              \
+        TapeDocument tape;                                 \
+        EXPECT_EQ(tape.parse(json), PARSE_OK);             \
+        StringWriteStream os2;                             \
+        Writer writer2(os2);                               \
+        tape.writeTo(writer2);                             \
+        EXPECT_EQ(os1.get(), os2.get());                   \
+    } while (false)
+
+TEST(json_tape, scalar) {
+    TapeDocument doc;
+    EXPECT_EQ(doc.parse("null"), PARSE_OK);
+    EXPECT_EQ(doc.getType(), TYPE_NULL);
+    EXPECT_EQ(doc.parse("true"), PARSE_OK);
+    EXPECT_TRUE(doc.root().getBool());
+    EXPECT_EQ(doc.parse("-2147483648"), PARSE_OK);
+    EXPECT_EQ(doc.root().getInt32(), -2147483648);
+    EXPECT_EQ(doc.parse("-9223372036854775808"), PARSE_OK);
+    EXPECT_EQ(doc.root().getInt64(), std::numeric_limits<int64_t>::min());
+    EXPECT_EQ(doc.parse("-1.5e10"), PARSE_OK);
+    EXPECT_EQ(doc.root().getDouble(), -1.5e10);
+    EXPECT_EQ(doc.parse("NaN"), PARSE_OK);
+    EXPECT_TRUE(std::isnan(doc.root().getDouble()));
+    EXPECT_EQ(doc.parse("\"蛤\\u0000蛤\""), PARSE_OK);
+    EXPECT_EQ(doc.root().getString(), "蛤\0蛤"sv);
+    EXPECT_EQ(doc.parse("[1, 2"), PARSE_MISS_COMMA_OR_SQUARE_BRACKET);
+}
+
+TEST(json_tape, object) {
+    TapeDocument doc;
+    ParseError err = doc.parse(
+            " { "
+            "\"n\" : null , "
+            "\"i\" : 123 , "
+            "\"l\" : 12345678901 , "
+            "\"s\" : \"abc\", "
+            "\"a\" : [ 1, 2, 3 ],"
+            "\"o\" : { \"1\" : 1, \"2\" : [], \"3\" : {} }"
+            " } ");
+    EXPECT_EQ(err, PARSE_OK);
+    EXPECT_EQ(doc.getType(), TYPE_OBJECT_PTR);
+    EXPECT_EQ(doc.root().size(), 6);
+    EXPECT_TRUE(doc["n"].isNull());
+    EXPECT_EQ(doc["i"].getInt32(), 123);
+    EXPECT_EQ(doc["l"].getInt64(), 12345678901LL);
+    EXPECT_EQ(doc["s"].getString(), "abc");
+    EXPECT_EQ(doc["a"].size(), 3);
+    EXPECT_EQ(doc["a"][2].getInt32(), 3);
+    EXPECT_EQ(doc["o"]["2"].getType(), TYPE_ARRAY_PTR);
+    EXPECT_EQ(doc["o"]["3"].size(), 0);
+
+    TapeValue v = doc.root();
+    EXPECT_FALSE(doc.root().findMember("x", v));
+
+    std::string keys;
+    for (auto it = doc["o"].begin(); it != doc["o"].end(); ++it) {
+        keys += it.key();
+    }
+    EXPECT_EQ(keys, "123");
+
+    int32_t sum = 0;
+    for (TapeValue e: doc["a"]) {
+        sum += e.getInt32();
+    }
+    EXPECT_EQ(sum, 6);
+}
+
+TEST(json_tape, write) {
+    TEST_SAME_AS_DOCUMENT("[]");
+    TEST_SAME_AS_DOCUMENT("{}");
+    TEST_SAME_AS_DOCUMENT("[null,false,true,123,12345678901,0.5,\"abc\",[1,[2,[]]],{\"a\":{}}]");
+    for (auto& s : sample) {
+        TEST_SAME_AS_DOCUMENT(s);
+    }
+
+    TapeDocument doc;
+    StringReadStream is(sample[0]);
+    EXPECT_EQ(StructuralReader::parse(is, doc), PARSE_OK);
+    EXPECT_EQ(doc[1]["City"].getString(), "SUNNYVALE");
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,4 +1,6 @@
 #include <TinyJSON/Document.h>
+#include <TinyJSON/WriteStream.h>
+#include <TinyJSON/Writer.h>
 #include <gtest/gtest.h>
 #include <string_view>
 
@@ -90,6 +92,17 @@ TEST(json_value, number) {
     TEST_DOUBLE(-2.2250738585072014e-308, "-2.2250738585072014e-308");
     TEST_DOUBLE(1.7976931348623157e308, "1.7976931348623157e308");
     TEST_DOUBLE(-1.7976931348623157e308, "-1.7976931348623157e308");
+    // the halfway and subnormal cases, more significant digits than fit in 64 bits, underflow
+    TEST_DOUBLE(9007199254740992.0, "9007199254740993.0");
+    TEST_DOUBLE(1e23, "1e23");
+    TEST_DOUBLE(2.2250738585072011e-308, "2.2250738585072011e-308");
+    TEST_DOUBLE(0.0, "2.4703282292062327e-324");
+    TEST_DOUBLE(4.9406564584124654e-324, "2.4703282292062328e-324");
+    TEST_DOUBLE(1.7976931348623157e308, "1.7976931348623158e308");
+    TEST_DOUBLE(0.1, "0.1000000000000000000000000000000000000001");
+    TEST_DOUBLE(123456789012345678901234567890.0, "123456789012345678901234567890.0");
+    TEST_DOUBLE(0.0, "1e-400");
+    TEST_DOUBLE(-0.0, "-1e-99999999999");
     TEST_DOUBLE(INFINITY, "Infinity");
     TEST_DOUBLE(NAN, "NaN");
 
@@ -138,6 +151,74 @@ TEST(json_value, string_) {
     TEST_STRING("\xE2\x82\xAC", "\"\\u20AC\"");            /* Euro € */
     TEST_STRING("\xF0\x9D\x84\x9E", "\"\\uD834\\uDD1E\""); /* G clef  𝄞 */
     TEST_STRING("\xF0\x9D\x84\x9E", "\"\\ud834\\udd1e\""); /* G clef  𝄞 */
+
+    /* longer than one SIMD block, with special characters on both sides of the block boundaries */
+    TEST_STRING("0123456789abcdef0123456789abcdef0123456789abcdef",
+                "\"0123456789abcdef0123456789abcdef0123456789abcdef\"");
+    TEST_STRING("0123456789abcdef0123456789abcde\"0123456789abcdef\n",
+                "\"0123456789abcdef0123456789abcde\\\"0123456789abcdef\\n\"");
+    TEST_STRING("0123456789abcde\\0123456789abcdef0123456789abcdef\t0",
+                "\"0123456789abcde\\\\0123456789abcdef0123456789abcdef\\t0\"");
+}
+
+TEST(json_value, short_string) {
+    EXPECT_EQ(sizeof(Value), 16u);
+
+    // up to SHORT_STRING_LENGTH bytes inline, a node past that
+    std::string_view fits = "0123456789abcd", longer = "0123456789abcde";
+    for (auto mode: {Document::ALLOC_HEAP, Document::ALLOC_ARENA}) {
+        Document doc(mode);
+        ASSERT_EQ(doc.parse(R"(["0123456789abcd", "0123456789abcde", "a\u0000b", ""])"), PARSE_OK);
+        Array& array = *doc.getData<ArrayPtr>();
+        EXPECT_TRUE(array[0].isShortString());
+        EXPECT_EQ(array[0].getString(), fits);
+        EXPECT_FALSE(array[1].isShortString());
+        EXPECT_EQ(array[1].getString(), longer);
+        EXPECT_EQ(*array[1].getData<StringPtr>(), longer);
+        // a copy of an inline string, writing to it leaves the value alone
+        StringPtr copied = array[0].getData<StringPtr>();
+        EXPECT_EQ(*copied, fits);
+        EXPECT_EQ(copied.useCount(), 1u);
+        copied->clear();
+        EXPECT_EQ(array[0].getString(), fits);
+        EXPECT_EQ(array[2].getString(), "a\0b"sv);
+        EXPECT_TRUE(array[3].isShortString());
+        EXPECT_EQ(array[3].getString(), "");
+    }
+
+    // the strings of the value tests, read without a node
+    Document doc;
+    ASSERT_EQ(doc.parse(R"({"s": "abc", "a": ["hehe", "Hello\nWorld", "\u20AC"]})"), PARSE_OK);
+    EXPECT_EQ(doc["s"].getString(), "abc");
+    EXPECT_EQ(doc["a"][0].getString(), "hehe");
+    EXPECT_EQ(doc["a"][1].getString(), "Hello\nWorld");
+    EXPECT_EQ(doc["a"][2].getString(), "\xE2\x82\xAC");
+
+    Value inlined(fits), node(longer);
+    Value copy = inlined;
+    EXPECT_EQ(copy.getString(), fits);
+    EXPECT_NE(copy.getString().data(), inlined.getString().data());
+    copy = node;
+    EXPECT_EQ(copy.getString().data(), node.getString().data());
+    EXPECT_EQ(node.getData<StringPtr>().useCount(), 3u);
+    Value moved = std::move(copy);
+    EXPECT_EQ(copy.getType(), TYPE_NULL);
+    EXPECT_EQ(moved.getString(), longer);
+
+    String s("short");
+    moved = moved.setData(s);
+    EXPECT_TRUE(moved.isShortString());
+    EXPECT_EQ(moved.getString(), "short");
+    EXPECT_EQ(node.getData<StringPtr>().useCount(), 2u);
+    inlined = 42;
+    EXPECT_EQ(inlined.getType(), TYPE_INT32);
+    EXPECT_EQ(inlined.getData<int32_t>(), 42);
+}
+
+TEST(json_value, whitespace) {
+    TEST_NULL("                                                                null");
+    TEST_NULL("\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\tnull\r\n");
+    TEST_NULL("null                                                                ");
 }
 
 TEST(json_value, array) {
@@ -248,6 +329,374 @@ TEST(json_value, object) {
     EXPECT_EQ(obj["3"].getData<int32_t>(), 3);
 }
 
+TEST(json_value, accessors) {
+    static_assert(std::is_nothrow_move_constructible_v<Document> && std::is_nothrow_move_assignable_v<Document>);
+    static_assert(std::is_nothrow_move_constructible_v<Writer<StringWriteStream>>);
+
+    Document doc;
+    ASSERT_EQ(doc.parse(R"({"a": [1, 2, 3], "o": {"x": true}, "s": "a string stored in a node"})"), PARSE_OK);
+    const Document& view = doc;
+    EXPECT_EQ(view.size(), 3u);
+    EXPECT_EQ(view["a"].size(), 3u);
+
+    // reading by reference leaves the reference counts alone
+    StringPtr s = doc["s"].getData<StringPtr>();
+    EXPECT_EQ(s.useCount(), 2u);
+    int32_t sum = 0;
+    for (auto& element: view["a"].elements()) sum += element.getData<int32_t>();
+    for (auto& [key, value]: view.members()) {
+        if (key.getString() == "o") {
+            EXPECT_TRUE(value["x"].getData<bool>());
+        }
+    }
+    EXPECT_EQ(sum, 6);
+    EXPECT_EQ(&view["a"].getArray(), &doc["a"].getArray());
+    EXPECT_EQ(view.getObject().size(), 3u);
+    StringWriteStream os;
+    Writer writer(os);
+    view.writeTo(writer);
+    EXPECT_EQ(s.useCount(), 2u);
+
+    // the elements are moved when the array grows
+    doc["a"].getArray().reserve(3);
+    for (int i = 0; i < 100; i++) doc["a"].addToArray(Value("a string stored in a node"));
+    doc["a"].addToArray(Value(doc["s"]));
+    EXPECT_EQ(s.useCount(), 3u);
+    doc["a"].getArray().resize(3);
+    EXPECT_EQ(s.useCount(), 2u);
+
+    doc.getObject().emplace_back(Value("k"), Value(1));
+    doc.getObject().reindex();
+    EXPECT_EQ(doc["k"].getData<int32_t>(), 1);
+
+    Document moved(std::move(doc));
+    EXPECT_EQ(moved["a"].size(), 3u);
+    EXPECT_EQ(s.useCount(), 2u);
+}
+
+TEST(json_value, ownership) {
+    const char* json = R"({"s": "a string stored in a node", "a": [1, "another string stored in a node"]})";
+    std::string expect = R"({"s":"a string stored in a node","a":[1,"another string stored in a node"]})";
+    auto write = [](const Value& v) {
+        StringWriteStream os;
+        Writer writer(os);
+        v.writeTo(writer);
+        return std::string(os.get());
+    };
+
+    for (auto [mode, ownership]: {std::pair{Document::ALLOC_HEAP, OWN_SHARED}, {Document::ALLOC_HEAP, OWN_UNIQUE},
+                                  {Document::ALLOC_ARENA, OWN_UNIQUE}, {Document::ALLOC_ARENA, OWN_BORROWED}}) {
+        Document doc(mode, ownership);
+        ASSERT_EQ(doc.parse(json), PARSE_OK);
+        EXPECT_EQ(doc.getOwnership(), ownership);
+        EXPECT_EQ(doc["a"].getOwnership(), ownership);
+        EXPECT_EQ(doc["a"][0].getOwnership(), OWN_SHARED);
+
+        Value copy = doc["a"];
+        EXPECT_EQ(copy.getOwnership(), ownership);
+        // only a unique node is copied
+        EXPECT_EQ(&copy.getArray() == &doc["a"].getArray(), ownership != OWN_UNIQUE);
+        EXPECT_EQ(copy[1].getString().data() == doc["a"][1].getString().data(), ownership != OWN_UNIQUE);
+        EXPECT_EQ(doc["a"].getData<ArrayPtr>().useCount(), ownership == OWN_SHARED ? 3u : 2u);
+        copy.addToArray(2);
+        EXPECT_EQ(doc["a"].size(), ownership == OWN_UNIQUE ? 2u : 3u);
+        doc["a"].getArray().resize(2);
+
+        // a unique copy lives on the heap, whatever the document uses
+        if (ownership == OWN_UNIQUE) {
+            EXPECT_EQ(copy.getArray().get_allocator().resource(), std::pmr::get_default_resource());
+        }
+        Value again = doc;
+        EXPECT_EQ(write(again), expect);
+        EXPECT_EQ(write(doc), expect);
+
+        doc.reset();
+        ASSERT_EQ(doc.parse("[\"a string stored in a node\"]"), PARSE_OK);
+        EXPECT_EQ(doc[0].getOwnership(), ownership);
+    }
+
+    // strings of a shared pool are borrowed from it
+    auto shared = std::make_shared<StringPool>();
+    StringPtr pooled = shared->intern("a string stored in a node");
+    std::shared_ptr<const StringPool> frozen = shared;
+    {
+        Document doc(Document::ALLOC_ARENA, OWN_BORROWED, Document::INTERN_STRINGS, frozen);
+        ASSERT_EQ(doc.parse(json), PARSE_OK);
+        EXPECT_EQ(doc["s"].getOwnership(), OWN_BORROWED);
+        EXPECT_EQ(doc["s"].getString().data(), pooled->data());
+        EXPECT_EQ(pooled.useCount(), 2u);
+        EXPECT_EQ(write(doc), expect);
+    }
+    EXPECT_EQ(pooled.useCount(), 2u);
+
+    Value unique(ArrayPtr::make(std::pmr::get_default_resource()), OWN_UNIQUE);
+    unique.addToArray(Value("a string stored in a node"));
+    Value copy = unique;
+    EXPECT_NE(copy.getArray().data(), unique.getArray().data());
+    EXPECT_EQ(copy.getData<ArrayPtr>().useCount(), 2u);
+}
+
+TEST(json_value, object_lookup) {
+    // large enough for the hash index, with a duplicate key
+    std::string json = "{";
+    for (int i = 0; i < 1000; i++) json += "\"key" + std::to_string(i) + "\": " + std::to_string(i) + ", ";
+    json += "\"key7\": -1}";
+    for (auto mode: {Document::ALLOC_HEAP, Document::ALLOC_ARENA}) {
+        Document doc(mode);
+        ASSERT_EQ(doc.parse(json), PARSE_OK);
+        for (int i = 0; i < 1000; i++) {
+            std::string key = "key" + std::to_string(i);
+            ASSERT_NE(doc.findPair(key), nullptr);
+            EXPECT_EQ(doc[key].getData<int32_t>(), i);
+        }
+        EXPECT_EQ(doc.findPair("key1000"), nullptr);
+        EXPECT_EQ(doc.findPair(""), nullptr);
+
+        constexpr KeyToken key7("key7");
+        EXPECT_EQ(doc[key7].getData<int32_t>(), 7);
+        EXPECT_EQ(doc.findPair(KeyToken("key999"))->second.getData<int32_t>(), 999);
+        EXPECT_EQ(doc.findPair(KeyToken("nope")), nullptr);
+
+        // appended after the index was built
+        doc.addPair("added", 5);
+        EXPECT_EQ(doc["added"].getData<int32_t>(), 5);
+        EXPECT_EQ(doc.findPair("key1000"), nullptr);
+
+        // renamed in place, found again after reindex()
+        Object& members = *doc.getData<ObjectPtr>();
+        members[3].first = Value("renamed");
+        members.reindex();
+        EXPECT_EQ(doc["renamed"].getData<int32_t>(), 3);
+        EXPECT_EQ(doc.findPair("key3"), nullptr);
+
+        // fewer members than the index covers, searched linearly
+        members.resize(10);
+        EXPECT_EQ(doc["key9"].getData<int32_t>(), 9);
+        EXPECT_EQ(doc.findPair("key10"), nullptr);
+    }
+}
+
+TEST(json_value, interning) {
+    // long enough not to be stored inline
+    const char* json = R"([{"name": "a long string value, too long to be pooled", "country_of_origin": "United States", "postal_code_or_zip": "San Francisco 94107"},
+                          {"name": "a long string value, too long to be pooled", "country_of_origin": "Canada, North America", "postal_code_or_zip": "San Francisco 94107"},
+                          {"name": "a long string value, too long to be pooled", "country_of_origin": "United States", "postal_code_or_zip": "New York City 10001"}])";
+    // the same pooled string is the same bytes
+    auto keyOf = [](Value& record, size_t i) { return (*record.getData<ObjectPtr>())[i].first.getString().data(); };
+    auto at = [](Value& v) { return v.getString().data(); };
+
+    for (auto mode: {Document::ALLOC_HEAP, Document::ALLOC_ARENA}) {
+        Document keys(mode, Document::INTERN_KEYS);
+        ASSERT_EQ(keys.parse(json), PARSE_OK);
+        EXPECT_EQ(keyOf(keys[0], 1), keyOf(keys[2], 1));
+        EXPECT_EQ((*keys[2].getData<ObjectPtr>())[1].first.getString(), "country_of_origin");
+        EXPECT_NE(at(keys[0]["country_of_origin"]), at(keys[2]["country_of_origin"]));
+
+        Document strings(mode, Document::INTERN_STRINGS);
+        ASSERT_EQ(strings.parse(json), PARSE_OK);
+        EXPECT_EQ(keyOf(strings[0], 2), keyOf(strings[1], 2));
+        // "United States" fits inline, a copy in each value
+        EXPECT_TRUE(strings[0]["country_of_origin"].isShortString());
+        EXPECT_EQ(strings[0]["country_of_origin"].getString(), strings[2]["country_of_origin"].getString());
+        EXPECT_EQ(at(strings[0]["postal_code_or_zip"]), at(strings[1]["postal_code_or_zip"]));
+        EXPECT_NE(at(strings[0]["postal_code_or_zip"]), at(strings[2]["postal_code_or_zip"]));
+        // too long to be pooled
+        EXPECT_NE(at(strings[0]["name"]), at(strings[1]["name"]));
+
+        StringWriteStream expect, os;
+        Writer expectWriter(expect), writer(os);
+        Document plain;
+        ASSERT_EQ(plain.parse(json), PARSE_OK);
+        plain.writeTo(expectWriter);
+        strings.writeTo(writer);
+        EXPECT_EQ(expect.get(), os.get());
+
+        // a new pool after reset
+        strings.reset();
+        ASSERT_EQ(strings.parse(R"({"country_of_origin": "Canada, North America"})"), PARSE_OK);
+        EXPECT_EQ(strings["country_of_origin"].getString(), "Canada, North America");
+    }
+
+    // shared by documents, which only look strings up in it
+    auto shared = std::make_shared<StringPool>();
+    StringPtr canada = shared->intern("Canada, North America");
+    StringPtr country = shared->intern("country_of_origin");
+    std::shared_ptr<const StringPool> frozen = shared;
+    Document first(Document::ALLOC_ARENA, Document::INTERN_STRINGS, frozen);
+    Document second(Document::ALLOC_HEAP, Document::INTERN_STRINGS, frozen);
+    ASSERT_EQ(first.parse(json), PARSE_OK);
+    ASSERT_EQ(second.parse(json), PARSE_OK);
+    EXPECT_EQ(first[1]["country_of_origin"].getData<StringPtr>(), canada);
+    EXPECT_EQ(second[1]["country_of_origin"].getData<StringPtr>(), canada);
+    EXPECT_EQ(keyOf(second[2], 1), country->data());
+    EXPECT_NE(keyOf(second[1], 2), keyOf(first[1], 2));
+    EXPECT_EQ(shared->size(), 2u);
+
+    StringPool small(std::pmr::get_default_resource(), 1);
+    EXPECT_NE(small.intern("a"), nullptr);
+    EXPECT_EQ(small.intern("b"), nullptr);
+    EXPECT_EQ(small.intern("a"), *small.find("a"));
+}
+
+TEST(json_value, arena) {
+    Document doc(Document::ALLOC_ARENA);
+    ParseError err = doc.parse("{\"s\" : \"a string that does not fit in the inline buffer of std::string\", \"a\" : [1, \"x\", {}]}");
+    EXPECT_EQ(err, PARSE_OK);
+    EXPECT_EQ(*doc["s"].getData<StringPtr>(), "a string that does not fit in the inline buffer of std::string");
+    EXPECT_EQ(doc["a"].getData<ArrayPtr>()->size(), 3);
+    EXPECT_EQ(doc["a"][1].getString(), "x");
+    EXPECT_NE(doc["s"].getData<StringPtr>()->get_allocator().resource(), std::pmr::get_default_resource());
+    EXPECT_NE(doc["a"].getData<ArrayPtr>()->get_allocator().resource(), std::pmr::get_default_resource());
+
+    doc.reset();
+    err = doc.parse("[true]");
+    EXPECT_EQ(err, PARSE_OK);
+    EXPECT_EQ((*doc.getData<ArrayPtr>())[0].getData<bool>(), true);
+
+    Document moved = std::move(doc);
+    EXPECT_EQ(moved.getType(), TYPE_ARRAY_PTR);
+
+    Document heap;
+    err = heap.parse("\"a string that does not fit in the inline buffer of std::string\"");
+    EXPECT_EQ(err, PARSE_OK);
+    EXPECT_EQ(heap.getData<StringPtr>()->get_allocator().resource(), std::pmr::get_default_resource());
+}
+
+// Counts what is allocated through it, from the heap
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    size_t allocations = 0;
+    size_t live = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        allocations++;
+        live++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        live--;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+};
+
+TEST(json_value, memory_resource) {
+    const char* json = R"({"s": "a string that does not fit inline", "a": [1, "another long string value"]})";
+    CountingResource counting;
+    {
+        Document doc(&counting, OWN_SHARED, Document::INTERN_KEYS);
+        EXPECT_EQ(doc.getAllocation(), Document::ALLOC_RESOURCE);
+        ASSERT_EQ(doc.parse(json), PARSE_OK);
+        EXPECT_GT(counting.allocations, 0u);
+        EXPECT_EQ(doc["s"].getData<StringPtr>()->get_allocator().resource(), &counting);
+        EXPECT_EQ(doc["a"].getArray().get_allocator().resource(), &counting);
+
+        // added strings come from the resource of their array or object
+        size_t before = counting.allocations;
+        doc["a"].addToArray(String("a third string that does not fit inline"));
+        doc.addPair("a key that does not fit inline", "and a value which does not either");
+        EXPECT_GT(counting.allocations, before);
+        EXPECT_EQ(doc["a"][2].getData<StringPtr>()->get_allocator().resource(), &counting);
+
+        doc.reset();
+        EXPECT_EQ(counting.live, 0u);
+        ASSERT_EQ(doc.parse(json), PARSE_OK);
+    }
+    EXPECT_EQ(counting.live, 0u);
+
+    // a buffer on the stack, with nowhere to go when it is full
+    std::byte buffer[16 * 1024];
+    std::pmr::monotonic_buffer_resource stack(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    {
+        Document doc(&stack, OWN_BORROWED);
+        ASSERT_EQ(doc.parse(json), PARSE_OK);
+        EXPECT_EQ(doc["a"][1].getString(), "another long string value");
+        EXPECT_EQ(doc["a"].getOwnership(), OWN_BORROWED);
+    }
+    stack.release();
+
+    Value array = Value::emptyArray(&counting);
+    array.addToArray(String("a string that does not fit inline"));
+    Value str("a string that does not fit inline", &counting);
+    EXPECT_GE(counting.live, 3u);
+    array = Value();
+    str = Value();
+    EXPECT_EQ(counting.live, 0u);
+}
+
+TEST(json_value, reuse) {
+    CountingResource counting;
+    Arena arena(&counting);
+    for (int i = 0; i < 3; i++) {
+        std::pmr::vector<int> ints(&arena);
+        ints.resize(10000);
+        std::pmr::string str(5000, 'x', &arena);
+        arena.release();
+    }
+    // the second round fits in the memory kept by the first
+    EXPECT_GE(arena.capacity(), 10000 * sizeof(int) + 5000);
+    size_t warm = counting.allocations;
+    for (int i = 0; i < 3; i++) {
+        std::pmr::vector<int> ints(&arena);
+        ints.resize(10000);
+        arena.release();
+    }
+    EXPECT_EQ(counting.allocations, warm);
+    // the memory kept is upstream's too
+    EXPECT_GT(counting.live, 0u);
+    arena.release(false);
+    EXPECT_EQ(arena.capacity(), 0u);
+    EXPECT_EQ(counting.live, 0u);
+    {
+        Arena kept(&counting);
+        std::pmr::vector<int>(10000, &kept);
+        kept.release();
+        EXPECT_GT(kept.capacity(), 0u);
+        EXPECT_EQ(counting.live, 1u);
+    }
+    EXPECT_EQ(counting.live, 0u);
+
+    auto message = [](int i) {
+        return R"({"id": )" + std::to_string(i) + R"(, "name": "message number )" + std::to_string(i) +
+               R"(", "tags": ["a", "b\tc"], "values": [1, 2, 3, 4, 5, 6, 7, 8], "nested": {"deeper": [{}]}})";
+    };
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(&counting);
+    for (auto interning: {Document::INTERN_NONE, Document::INTERN_STRINGS}) {
+        Document doc(Document::ALLOC_ARENA, OWN_BORROWED, interning);
+        size_t before = 0;
+        for (int i = 0; i < 100; i++) {
+            if (i == 10) before = counting.allocations;
+            // parse() resets a used document, even after an error
+            ASSERT_EQ(doc.parse(message(i)), PARSE_OK);
+            EXPECT_EQ(doc["id"].getData<int32_t>(), i);
+            EXPECT_EQ(doc["tags"][1].getString(), "b\tc");
+            EXPECT_NE(doc.parse("[1, {\"a\": ]"), PARSE_OK);
+        }
+        EXPECT_EQ(counting.allocations, before);
+    }
+    std::pmr::set_default_resource(previous);
+
+    // the buffers of the parser are kept by a context
+    Reader::Context ctx;
+    Document doc;
+    StringReadStream is(R"(["a long string with an escape\n to unescape", [[[]]]])");
+    EXPECT_EQ(Reader::parse(is, doc, ctx), PARSE_OK);
+    size_t capacity = ctx.scratch.capacity();
+    EXPECT_GT(capacity, 40u);
+    StringReadStream again(R"("short\n")");
+    doc.reset();
+    EXPECT_EQ(Reader::parse(again, doc, ctx), PARSE_OK);
+    EXPECT_EQ(doc.getString(), "short\n");
+    EXPECT_EQ(ctx.scratch.capacity(), capacity);
+
+    doc.reset(false);
+    EXPECT_EQ(doc.parse("[true]"), PARSE_OK);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();